@@ -0,0 +1,163 @@
+#include <benchmark/benchmark.h>
+#include "bin_key.hpp"
+#include "direct_index.hpp"
+#include "prefix_index.hpp"
+#include <algorithm>
+#include <cctype>
+#include <optional>
+#include <string>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+using namespace LibBIN;
+
+// Synthetic key sets for comparing index layouts independently of the CSV:
+// state.range(0) distinct keys, 90% 6-digit and 10% 8-digit.
+static auto index_keys(std::size_t count) -> std::vector<std::uint32_t> {
+    std::mt19937 rng(42);
+    std::vector<std::uint32_t> keys;
+    keys.reserve(count);
+    while (keys.size() < count) {
+        bool long_bin = rng() % 10 == 0;
+        std::uint32_t padded = long_bin ? rng() % 100'000'000 : (rng() % 1'000'000) * 100;
+        keys.push_back(padded << 2 | (long_bin ? 2u : 0u));
+        if (keys.size() == count) {
+            std::sort(keys.begin(), keys.end());
+            keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+        }
+    }
+    return keys;
+}
+
+static auto index_probes(const std::vector<std::uint32_t>& keys) -> std::vector<BinKey> {
+    std::mt19937 rng(7);
+    std::vector<BinKey> probes(4096);
+    for (auto& probe : probes) probe = BinKey{keys[rng() % keys.size()]};
+    return probes;
+}
+
+static void BM_Index_Hash(benchmark::State& state) {
+    auto keys = index_keys(static_cast<std::size_t>(state.range(0)));
+    std::unordered_map<std::uint32_t, std::uint32_t> index;
+    for (std::size_t id = 0; id < keys.size(); ++id) index.emplace(keys[id], static_cast<std::uint32_t>(id));
+    auto probes = index_probes(keys);
+    std::size_t i = 0;
+    for (auto _ : state) {
+        auto it = index.find(probes[i++ & 4095].packed);
+        benchmark::DoNotOptimize(it);
+    }
+}
+
+static void BM_Index_Sorted(benchmark::State& state) {
+    auto keys = index_keys(static_cast<std::size_t>(state.range(0)));
+    auto probes = index_probes(keys);
+    std::size_t i = 0;
+    for (auto _ : state) {
+        auto it = std::lower_bound(keys.begin(), keys.end(), probes[i++ & 4095].packed);
+        benchmark::DoNotOptimize(it);
+    }
+}
+
+static void BM_Index_Direct(benchmark::State& state) {
+    auto keys = index_keys(static_cast<std::size_t>(state.range(0)));
+    DirectIndex index(keys);
+    auto probes = index_probes(keys);
+    std::size_t i = 0;
+    for (auto _ : state) {
+        auto id = index.find(probes[i++ & 4095]);
+        benchmark::DoNotOptimize(id);
+    }
+}
+
+// Dependent-free lookups over a large probe set, resolved one by one and
+// with the slot for the key `distance` entries ahead prefetched first.
+static void BM_Index_Direct_Prefetch(benchmark::State& state) {
+    auto keys = index_keys(500'000);
+    DirectIndex index(keys);
+    std::mt19937 rng(9);
+    std::vector<BinKey> probes(1 << 16);
+    for (auto& probe : probes) probe = BinKey{static_cast<std::uint32_t>(rng() % 1'000'000) * 100 << 2};
+    const std::size_t distance = static_cast<std::size_t>(state.range(0));
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < probes.size(); ++i) {
+            if (distance > 0 && i + distance < probes.size()) index.prefetch(probes[i + distance]);
+            auto id = index.find(probes[i]);
+            benchmark::DoNotOptimize(id);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(probes.size()));
+}
+
+// Longest-prefix resolution of 8-digit queries: three hash probes, as
+// Search does for non-trie indexes, against one trie walk.
+static void BM_Index_Hash_Longest(benchmark::State& state) {
+    auto keys = index_keys(static_cast<std::size_t>(state.range(0)));
+    std::unordered_map<std::uint32_t, std::uint32_t> index;
+    for (std::size_t id = 0; id < keys.size(); ++id) index.emplace(keys[id], static_cast<std::uint32_t>(id));
+    auto probes = index_probes(keys);
+    for (auto& probe : probes) probe = BinKey{(probe.padded() / 100 * 100 + 99) << 2 | 2u};
+    std::size_t i = 0;
+    for (auto _ : state) {
+        BinKey key = probes[i++ & 4095];
+        auto it = index.end();
+        for (std::size_t digits = BinKey::max_digits; digits >= BinKey::min_digits && it == index.end(); --digits) {
+            it = index.find(key.prefix(digits).packed);
+        }
+        benchmark::DoNotOptimize(it);
+    }
+}
+
+static void BM_Index_Prefix_Longest(benchmark::State& state) {
+    auto keys = index_keys(static_cast<std::size_t>(state.range(0)));
+    PrefixIndex index(keys);
+    auto probes = index_probes(keys);
+    for (auto& probe : probes) probe = BinKey{(probe.padded() / 100 * 100 + 99) << 2 | 2u};
+    std::size_t i = 0;
+    for (auto _ : state) {
+        auto id = index.find_longest(probes[i++ & 4095]);
+        benchmark::DoNotOptimize(id);
+    }
+}
+
+static auto parse_probes() -> std::vector<std::string> {
+    std::vector<std::string> bins;
+    for (auto key : index_probes(index_keys(10'000))) bins.push_back(key.to_string());
+    return bins;
+}
+
+// The pre-BinKey path: std::isdigit validation then a std::string copy for hashing.
+static void BM_Parse_IsDigitString(benchmark::State& state) {
+    auto bins = parse_probes();
+    for (auto _ : state) {
+        for (const auto& bin : bins) {
+            bool valid = bin.size() >= 6 && bin.size() <= 8 &&
+                std::all_of(bin.begin(), bin.end(), [](unsigned char c) { return std::isdigit(c); });
+            std::size_t hash = valid ? std::hash<std::string>{}(std::string(bin)) : 0;
+            benchmark::DoNotOptimize(hash);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(bins.size()));
+}
+
+// state.range(0) is the SimdLevel: 0 scalar, 1 SSSE3, 2 AVX2.
+static void BM_ParseBins(benchmark::State& state) {
+    auto strings = parse_probes();
+    std::vector<std::string_view> bins(strings.begin(), strings.end());
+    std::vector<std::optional<BinKey>> out(bins.size());
+    auto level = static_cast<SimdLevel>(state.range(0));
+    for (auto _ : state) {
+        parse_bins(bins, out, level);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(bins.size()));
+}
+
+BENCHMARK(BM_Index_Hash)->Arg(10'000)->Arg(500'000);
+BENCHMARK(BM_Index_Sorted)->Arg(10'000)->Arg(500'000);
+BENCHMARK(BM_Index_Direct)->Arg(10'000)->Arg(500'000);
+BENCHMARK(BM_Index_Direct_Prefetch)->Arg(0)->Arg(8)->Arg(16);
+BENCHMARK(BM_Index_Hash_Longest)->Arg(10'000)->Arg(500'000);
+BENCHMARK(BM_Index_Prefix_Longest)->Arg(10'000)->Arg(500'000);
+BENCHMARK(BM_Parse_IsDigitString);
+BENCHMARK(BM_ParseBins)->Arg(0)->Arg(1)->Arg(2);
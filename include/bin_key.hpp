@@ -0,0 +1,112 @@
+#pragma once
+
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace LibBIN {
+    // A 6-8 digit BIN packed into 32 bits: the digits right-padded with zeros
+    // to eight places, shifted left by two, with (digit count - 6) in the low
+    // bits. Ordering by `packed` keeps a BIN directly ahead of its 7/8-digit
+    // extensions and preserves leading zeros.
+    struct BinKey {
+        std::uint32_t packed = 0;
+
+        static constexpr std::size_t min_digits = 6;
+        static constexpr std::size_t max_digits = 8;
+
+        [[nodiscard]] static constexpr auto parse(std::string_view bin) noexcept -> std::optional<BinKey> {
+            if (bin.size() < min_digits || bin.size() > max_digits) return std::nullopt;
+            std::uint32_t value = 0;
+            for (char c : bin) {
+                if (c < '0' || c > '9') return std::nullopt;
+                value = value * 10 + static_cast<std::uint32_t>(c - '0');
+            }
+            for (std::size_t i = bin.size(); i < max_digits; ++i) value *= 10;
+            return BinKey{(value << 2) | static_cast<std::uint32_t>(bin.size() - min_digits)};
+        }
+
+        [[nodiscard]] constexpr auto digits() const noexcept -> std::size_t {
+            return (packed & 3u) + min_digits;
+        }
+
+        [[nodiscard]] constexpr auto padded() const noexcept -> std::uint32_t {
+            return packed >> 2;
+        }
+
+        // The highest 8-digit value this BIN covers, e.g. 41111199 for 411111.
+        [[nodiscard]] constexpr auto padded_last() const noexcept -> std::uint32_t {
+            constexpr std::uint32_t span[] = {100, 10, 1};
+            return padded() + span[digits() - min_digits] - 1;
+        }
+
+        // The leading `n` digits, for min_digits <= n <= digits().
+        [[nodiscard]] constexpr auto prefix(std::size_t n) const noexcept -> BinKey {
+            constexpr std::uint32_t scale[] = {1, 10, 100};
+            std::uint32_t drop = scale[max_digits - n];
+            return BinKey{(padded() / drop * drop) << 2 | static_cast<std::uint32_t>(n - min_digits)};
+        }
+
+        [[nodiscard]] auto to_string() const -> std::string {
+            std::string out(digits(), '0');
+            std::uint32_t value = padded();
+            for (std::size_t i = digits(); i < max_digits; ++i) value /= 10;
+            for (std::size_t i = out.size(); i-- > 0; value /= 10) {
+                out[i] = static_cast<char>('0' + value % 10);
+            }
+            return out;
+        }
+
+        friend constexpr auto operator<=>(const BinKey&, const BinKey&) = default;
+    };
+
+    // An inclusive account range over 8-digit padded BIN values, written as
+    // "<first>-<last>" with 6-8 digits per side. The first side is padded
+    // with zeros and the last with nines, so "400000-400999" covers
+    // 40000000..40099999.
+    struct BinRange {
+        std::uint32_t first = 0;
+        std::uint32_t last = 0;
+
+        [[nodiscard]] static constexpr auto parse(std::string_view text) noexcept -> std::optional<BinRange> {
+            auto dash = text.find('-');
+            if (dash == std::string_view::npos) return std::nullopt;
+            auto first = BinKey::parse(text.substr(0, dash));
+            auto last = BinKey::parse(text.substr(dash + 1));
+            if (!first || !last || first->padded() > last->padded_last()) return std::nullopt;
+            return BinRange{first->padded(), last->padded_last()};
+        }
+
+        // True if every 8-digit value under `key` lies inside the range.
+        [[nodiscard]] constexpr auto contains(BinKey key) const noexcept -> bool {
+            return first <= key.padded() && key.padded_last() <= last;
+        }
+
+        friend constexpr auto operator<=>(const BinRange&, const BinRange&) = default;
+    };
+
+    enum class SimdLevel {
+        Scalar,
+        // One BIN per SSSE3 kernel call.
+        SSSE3,
+        // Four BINs per AVX2 kernel call in parse_bins.
+        AVX2,
+    };
+
+    // Best level the running CPU supports.
+    [[nodiscard]] auto detected_simd_level() noexcept -> SimdLevel;
+
+    // Vectorized equivalents of BinKey::parse: digits are validated and
+    // converted to the packed key in a few vector instructions. `level` is
+    // clamped to detected_simd_level().
+    [[nodiscard]] auto parse_bin(std::string_view bin) noexcept -> std::optional<BinKey>;
+    [[nodiscard]] auto parse_bin(std::string_view bin, SimdLevel level) noexcept -> std::optional<BinKey>;
+    // Parses bins[i] into out[i] for the first min(bins.size(), out.size()) entries.
+    void parse_bins(std::span<const std::string_view> bins, std::span<std::optional<BinKey>> out) noexcept;
+    void parse_bins(std::span<const std::string_view> bins, std::span<std::optional<BinKey>> out,
+                    SimdLevel level) noexcept;
+}
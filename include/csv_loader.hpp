@@ -0,0 +1,98 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <string>
+#include <string_view>
+#include "errors.hpp"
+#include "mapped_file.hpp"
+#include "snapshot.hpp"
+
+namespace LibBIN {
+    // One CSV record split into fields. Only the first max_fields fields are
+    // kept; `size` counts every field in the record.
+    struct CsvRow {
+        static constexpr std::size_t max_fields = 8;
+        std::array<std::string_view, max_fields> fields;
+        std::size_t size = 0;
+        // Backing storage for quoted fields containing escaped ("") quotes.
+        std::array<std::string, max_fields> unescaped;
+    };
+
+    // Streaming RFC 4180 tokenizer over a memory-mapped CSV file or an
+    // in-memory buffer. Input is scanned 64 bytes at a time into quote,
+    // comma and newline bitmasks; a prefix XOR over the quote mask marks
+    // quoted spans, so commas and newlines inside quotes are not
+    // structural. Fields are views into the input, except unescaped quoted
+    // fields which live in the row; a trailing '\r' is dropped.
+    class CsvReader {
+        public:
+            explicit CsvReader(std::string_view text) noexcept : text_(text) {}
+
+            static auto open(const std::string& path) -> std::expected<CsvReader, LookupError>;
+
+            // Tokenizes the next record into `row`; false once the input is exhausted.
+            auto next(CsvRow& row) -> bool;
+            // Bytes of input, for throughput reporting.
+            [[nodiscard]] auto size() const noexcept -> std::size_t { return text_.size(); }
+
+        private:
+            // Offset of the next unquoted comma or newline, or npos.
+            auto next_structural() noexcept -> std::size_t;
+
+            MappedFile file_;
+            std::string_view text_;
+            std::size_t pos_ = 0;
+            std::size_t block_ = 0;
+            std::size_t block_base_ = 0;
+            std::uint64_t structurals_ = 0;
+            // All ones while the scan is inside a quoted field.
+            std::uint64_t in_quotes_ = 0;
+            // Whether the last scanned byte was a quote.
+            std::uint64_t last_quote_ = 0;
+            // Offset of the second quote of the last "" pair scanned, or npos.
+            std::size_t last_pair_ = std::string_view::npos;
+    };
+
+    struct CsvStats {
+        std::size_t rows = 0;
+        std::size_t skipped_rows = 0;
+    };
+
+    // Reads a bin_data.csv export (header line, then
+    // bin,country,_,scheme,type,brand,bank) and passes each row to `row` as
+    // views into the mapped file. Rows with fewer than seven fields are
+    // counted in skipped_rows; BIN values are not validated.
+    auto read_bin_csv(const std::string& csv_path, const std::function<void(const RecordFields&)>& row)
+        -> std::expected<CsvStats, LookupError>;
+
+    enum class DeltaOp {
+        // Insert the record, or replace the one with the same BIN or range.
+        Upsert,
+        // Remove the record with the same BIN or range.
+        Delete,
+    };
+
+    // Reads a delta file: a header line, then
+    // op,bin,country,_,scheme,type,brand,bank rows where op is U (upsert) or
+    // D (delete; only the bin column is read). Rows with another op or too
+    // few fields are counted in skipped_rows.
+    auto read_bin_delta(const std::string& delta_path, const std::function<void(DeltaOp, const RecordFields&)>& row)
+        -> std::expected<CsvStats, LookupError>;
+
+    struct CsvSnapshot {
+        SnapshotWriter writer;
+        CsvStats stats;
+    };
+
+    // Adds every row of a bin_data.csv export to one writer using `threads`
+    // threads (0 = hardware concurrency). The file is split into chunks at
+    // newlines outside quoted fields, each parsed into its own writer and sorted;
+    // the sorted runs are then merged pairwise in file order, so duplicate
+    // BINs resolve exactly as with a sequential load.
+    auto read_bin_csv_parallel(const std::string& csv_path, unsigned threads)
+        -> std::expected<CsvSnapshot, LookupError>;
+}
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include "errors.hpp"
+#include "load_options.hpp"
+#include "result.hpp"
+#include "result_view.hpp"
+
+namespace LibBIN {
+    enum class MatchMode {
+        // Only a record for exactly the queried digits matches.
+        Exact,
+        // The record for the longest stored prefix (>= 6 digits) of the
+        // query matches, e.g. an 8-digit query falls back to its 6-digit BIN.
+        LongestPrefix,
+    };
+
+    // Outcome of Database::apply_delta.
+    struct DeltaStats {
+        std::size_t upserts = 0;
+        std::size_t deletes = 0;
+        // Rows with an unknown op, too few fields, or a malformed BIN, and
+        // range upserts overlapping a live range with different bounds.
+        std::size_t skipped_rows = 0;
+    };
+
+    // One BIN dataset with its own storage and index. Instances are
+    // independent, so several datasets can be resident side by side.
+    //
+    // The loaded data is immutable and published through an atomic pointer:
+    // lookups take no lock, and loading or reloading swaps in a rebuilt
+    // state, freeing the old one once every reader that could see it has
+    // finished. Results from Search are copies. Views from SearchView,
+    // TrySearch and SearchBatch point into the state they were found in,
+    // which any later publish may free: a load or reload, an apply_delta,
+    // or a compaction, including the background compaction an apply_delta
+    // can start on its own. Hold a ReadGuard across the lookup and every
+    // use of its views whenever other threads load, reload or apply
+    // deltas; without one, a view is only safe until this database's data
+    // next changes.
+    //
+    // Delta files are applied as a small overlay over the loaded base data:
+    // upserted records live in a snapshot of their own that shadows the
+    // base, and deletions mask base records by id. Once the overlay holds
+    // compaction_threshold entries it is folded into a rebuilt base on a
+    // background thread.
+    class Database {
+        public:
+            // Pins the database's current state for the guard's lifetime:
+            // views taken while it is alive remain valid, and loads wait for
+            // it before freeing the state they point into. A thread must not
+            // load into a database while it holds a guard on it.
+            class ReadGuard {
+                public:
+                    explicit ReadGuard(const Database& database) noexcept;
+                    ~ReadGuard();
+                    ReadGuard(const ReadGuard&) = delete;
+                    ReadGuard& operator=(const ReadGuard&) = delete;
+
+                private:
+                    const Database& database_;
+                    unsigned stripe_;
+                    unsigned parity_;
+            };
+
+            Database();
+            ~Database();
+            Database(const Database&) = delete;
+            Database& operator=(const Database&) = delete;
+
+            // Build from a BIN CSV export or a .lbin snapshot and publish the
+            // result, replacing any data already loaded. On failure the
+            // current data stays in place.
+            auto load_bins(const std::string& csv_path, const LoadOptions& options = {})
+                -> std::expected<void, LookupError>;
+            auto load_snapshot(const std::string& snapshot_path, const LoadOptions& options = {})
+                -> std::expected<void, LookupError>;
+            // Rebuilds from the source of the last successful load, dropping
+            // any applied deltas that were not written back to that source.
+            auto reload() -> std::expected<void, LookupError>;
+            // Applies a delta file (see read_bin_delta) on top of the current
+            // data and publishes the result; rows apply in file order, so a
+            // later row for the same BIN or range wins. A range upsert that
+            // overlaps a live range with other bounds is skipped; delete that
+            // range first to replace it. Costs time and memory
+            // in proportion to the accumulated overlay, not the database. On
+            // failure nothing is applied.
+            auto apply_delta(const std::string& delta_path) -> std::expected<DeltaStats, LookupError>;
+            // Folds the overlay into a rebuilt base index. Lookups continue
+            // against the current data meanwhile; deltas wait for it.
+            auto compact() -> std::expected<void, LookupError>;
+
+            [[nodiscard]] auto loaded() const noexcept -> bool;
+            // Records held: one per BIN plus one per range.
+            [[nodiscard]] auto size() const noexcept -> std::size_t;
+            // Upserted records plus deleted base records not yet compacted.
+            [[nodiscard]] auto overlay_size() const noexcept -> std::size_t;
+            // The index built for the current data; Auto before the first load.
+            [[nodiscard]] auto index_kind() const noexcept -> IndexKind;
+            // Bytes held by the snapshot image and the index.
+            [[nodiscard]] auto memory_usage() const noexcept -> std::size_t;
+
+            auto Search(std::string_view bin, MatchMode mode = MatchMode::Exact) const
+                -> std::expected<Result, LookupError>;
+            // Like Search, but returns a view into the loaded data instead of
+            // copying the record; a hit performs no allocation.
+            auto SearchView(std::string_view bin, MatchMode mode = MatchMode::Exact) const
+                -> std::expected<ResultView, LookupError>;
+            // Non-allocating lookup: hits return a view, misses and malformed
+            // input a compact SearchError whose message is formatted lazily.
+            auto TrySearch(std::string_view bin, MatchMode mode = MatchMode::Exact) const noexcept
+                -> std::expected<ResultView, SearchError>;
+            // TrySearch over many BINs: out[i] receives the result for bins[i]
+            // for the first min(bins.size(), out.size()) entries. Keys are
+            // parsed and their index slots prefetched several entries ahead
+            // so the cache misses of neighbouring lookups overlap.
+            void SearchBatch(std::span<const std::string_view> bins,
+                             std::span<std::expected<ResultView, SearchError>> out,
+                             MatchMode mode = MatchMode::Exact) const noexcept;
+
+            // Card number lookups. The PAN has 12-19 digits, optionally
+            // separated by spaces or dashes, and must pass the Luhn check;
+            // its record is the longest stored BIN (or range) prefixing its
+            // first eight digits. Errors carry only the first six characters
+            // of the input, never the full card number.
+            auto SearchPan(std::string_view pan) const -> std::expected<Result, LookupError>;
+            auto TrySearchPan(std::string_view pan) const noexcept -> std::expected<ResultView, SearchError>;
+            // TrySearchPan over many PANs, pipelined like SearchBatch.
+            void SearchPanBatch(std::span<const std::string_view> pans,
+                                std::span<std::expected<ResultView, SearchError>> out) const noexcept;
+
+            // Visits, in key order, every BIN record from `first` to `last`
+            // inclusive (6-8 digits each), where a BIN sorts directly before
+            // its longer extensions: "411100" to "41119999" covers every BIN
+            // starting with 4111. Ranges are not visited; applied deltas
+            // are. Returns the number of records visited. A load waits for
+            // the scan to finish, so `visit` must not load this database.
+            auto Scan(std::string_view first, std::string_view last,
+                      const std::function<void(const ResultView&)>& visit) const
+                -> std::expected<std::size_t, SearchError>;
+
+        private:
+            struct Base;
+            struct Overlay;
+            struct State;
+            struct Source {
+                bool snapshot = false;
+                std::string path;
+                LoadOptions options;
+            };
+
+            // Readers announce themselves in one of several cache-line sized
+            // stripes chosen per thread, so concurrent lookups rarely share
+            // a line. Each stripe counts readers per epoch parity: a load
+            // flips the epoch after swapping states and waits only for the
+            // readers counted under the previous parity, which started
+            // before the flip, so new readers cannot hold it up.
+            struct alignas(64) ReaderStripe {
+                mutable std::atomic<std::uint32_t> readers[2]{};
+            };
+            static constexpr unsigned reader_stripes = 64;
+
+            auto load(Source source) -> std::expected<void, LookupError>;
+            void publish(const State* next);
+
+            std::atomic<const State*> current_{nullptr};
+            std::mutex load_mutex_;
+            Source source_;
+            std::array<ReaderStripe, reader_stripes> stripes_;
+            std::atomic<unsigned> epoch_{0};
+            std::atomic<bool> compacting_{false};
+            std::jthread compactor_;
+    };
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "bin_key.hpp"
+#include "residency.hpp"
+
+namespace LibBIN {
+    // Direct-addressed index: a 6-digit BIN's numeric value is the slot of
+    // its record id in a 1,000,000-entry array, so a lookup is one load.
+    // Longer BINs live in a small sorted side table.
+    class DirectIndex {
+        public:
+            static constexpr std::uint32_t npos = 0xFFFFFFFFu;
+            static constexpr std::size_t slots = 1'000'000;
+
+            DirectIndex() = default;
+            // `keys` are sorted BinKey::packed values; a key's record id is its position.
+            explicit DirectIndex(std::span<const std::uint32_t> keys);
+
+            [[nodiscard]] auto find(BinKey key) const noexcept -> std::uint32_t {
+                if (key.digits() == BinKey::min_digits) {
+                    return table_.empty() ? npos : table_[key.padded() / 100];
+                }
+                return find_long(key);
+            }
+
+            // Starts loading the slot `find(key)` will read for a 6-digit key.
+            void prefetch(BinKey key) const noexcept {
+                if (key.digits() == BinKey::min_digits && !table_.empty()) {
+                    __builtin_prefetch(&table_[key.padded() / 100]);
+                }
+            }
+
+            [[nodiscard]] auto memory_usage() const noexcept -> std::size_t;
+            // The blocks counted by memory_usage(), for residency controls.
+            void memory_regions(std::vector<MemoryRegion>& out) const;
+
+        private:
+            [[nodiscard]] auto find_long(BinKey key) const noexcept -> std::uint32_t;
+
+            std::vector<std::uint32_t> table_;
+            std::vector<std::uint32_t> long_keys_;
+            std::vector<std::uint32_t> long_ids_;
+    };
+}
@@ -1,5 +1,6 @@
 #pragma once 
 
+#include <cstdint>
 #include <string_view>
 #include <string>
 #include <format>
@@ -25,4 +26,43 @@ namespace LibBIN {
             explicit InvalidFormatError(std::string_view bin)
                 : LookupError(std::format("Invalid BIN format: {}", bin)) {}
         };
-}
\ No newline at end of file
+    class InvalidChecksumError : public LookupError {
+        public:
+            explicit InvalidChecksumError(std::string_view pan)
+                : LookupError(std::format("Card number fails the Luhn check: {}...", pan)) {}
+        };
+
+    enum class ErrorCode : std::uint8_t {
+        NotLoaded,
+        InvalidFormat,
+        NotFound,
+        // A card number whose Luhn checksum does not match.
+        InvalidChecksum,
+    };
+
+    // Allocation-free error for Lookup::TrySearch: the code plus a view of
+    // the caller's query, which must outlive the error to be read back.
+    // to_error() builds the formatted LookupError only when asked.
+    class SearchError {
+        public:
+            constexpr SearchError(ErrorCode code, std::string_view input) noexcept
+                : input_(input), code_(code) {}
+            [[nodiscard]] constexpr auto code() const noexcept -> ErrorCode { return code_; }
+            [[nodiscard]] constexpr auto input() const noexcept -> std::string_view { return input_; }
+            [[nodiscard]] auto to_error() const -> LookupError {
+                switch (code_) {
+                    case ErrorCode::InvalidFormat: return InvalidFormatError{input_};
+                    case ErrorCode::NotFound: return NotFoundError{input_};
+                    case ErrorCode::InvalidChecksum: return InvalidChecksumError{input_};
+                    case ErrorCode::NotLoaded: break;
+                }
+                return LookupError("BIN database not loaded. Call load_bins() first.");
+            }
+            friend constexpr auto operator==(const SearchError& error, ErrorCode code) noexcept -> bool {
+                return error.code_ == code;
+            }
+        private:
+            std::string_view input_;
+            ErrorCode code_;
+        };
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "bin_key.hpp"
+#include "residency.hpp"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace LibBIN {
+    // Open-addressing hash table from packed BIN to record id, laid out
+    // like a Swiss table: slots come in groups of sixteen, each with a
+    // control byte holding seven bits of the key's hash, or `empty`. A
+    // probe compares a whole group's control bytes with one vector compare
+    // and only checks the slots whose bytes match, so a lookup usually
+    // reads one control line and one slot. Keys and ids sit inline, with no
+    // per-entry allocation. The table is built once and never modified.
+    class FlatHashIndex {
+        public:
+            static constexpr std::uint32_t npos = 0xFFFFFFFFu;
+            static constexpr std::size_t group_size = 16;
+
+            FlatHashIndex() = default;
+            // `keys` are distinct BinKey::packed values; a key's id is its position.
+            explicit FlatHashIndex(std::span<const std::uint32_t> keys);
+
+            [[nodiscard]] auto size() const noexcept -> std::size_t { return size_; }
+            [[nodiscard]] auto find(BinKey key) const noexcept -> std::uint32_t {
+                if (ctrl_.empty()) return npos;
+                const std::uint64_t h = hash(key.packed);
+                const auto tag = static_cast<std::int8_t>(h & 0x7F);
+                std::size_t group = (h >> 7) & group_mask_;
+                // Triangular steps over a power-of-two group count visit
+                // every group; the load factor leaves an empty slot to stop at.
+                for (std::size_t step = 1;; ++step) {
+                    const std::int8_t* ctrl = ctrl_.data() + group * group_size;
+                    for (unsigned match = match_mask(ctrl, tag); match != 0; match &= match - 1) {
+                        const Slot& slot = slots_[group * group_size + static_cast<std::size_t>(__builtin_ctz(match))];
+                        if (slot.key == key.packed) return slot.id;
+                    }
+                    if (match_mask(ctrl, empty) != 0) return npos;
+                    group = (group + step) & group_mask_;
+                }
+            }
+            // Starts loading the control bytes and slots of the key's first group.
+            void prefetch(BinKey key) const noexcept {
+                if (ctrl_.empty()) return;
+                const std::size_t group = (hash(key.packed) >> 7) & group_mask_;
+                __builtin_prefetch(ctrl_.data() + group * group_size);
+                __builtin_prefetch(slots_.data() + group * group_size);
+            }
+
+            [[nodiscard]] auto memory_usage() const noexcept -> std::size_t;
+            // The blocks counted by memory_usage(), for residency controls.
+            void memory_regions(std::vector<MemoryRegion>& out) const;
+
+        private:
+            static constexpr std::int8_t empty = -128;
+
+            struct Slot {
+                std::uint32_t key;
+                std::uint32_t id;
+            };
+
+            [[nodiscard]] static constexpr auto hash(std::uint32_t key) noexcept -> std::uint64_t {
+                std::uint64_t h = key * 0x9e3779b97f4a7c15ull;
+                return h ^ (h >> 29);
+            }
+            // Bit i set where control byte i equals `tag`.
+            [[nodiscard]] static auto match_mask(const std::int8_t* ctrl, std::int8_t tag) noexcept -> unsigned {
+#if defined(__SSE2__)
+                const __m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl));
+                return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(tag))));
+#else
+                unsigned mask = 0;
+                for (std::size_t i = 0; i < group_size; ++i) mask |= unsigned{ctrl[i] == tag} << i;
+                return mask;
+#endif
+            }
+
+            std::vector<std::int8_t> ctrl_;
+            std::vector<Slot> slots_;
+            std::size_t group_mask_ = 0;
+            std::size_t size_ = 0;
+    };
+}
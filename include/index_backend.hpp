@@ -0,0 +1,79 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+#include "bin_key.hpp"
+#include "load_options.hpp"
+#include "residency.hpp"
+
+namespace LibBIN {
+    // What Database needs from a point index over a snapshot's key table.
+    // A backend is built from the sorted BinKey::packed values, either by a
+    // constructor or, if the build can fail, by a static build() returning
+    // std::optional. A key's id is its position in that table; find()
+    // returns it or npos. Batch lookups prefetch() a block of keys before
+    // finding them, so prefetch() should start loading whatever find() reads
+    // first.
+    template <class T>
+    concept IndexBackend =
+        (std::constructible_from<T, std::span<const std::uint32_t>>
+         || requires(std::span<const std::uint32_t> keys) {
+                { T::build(keys) } -> std::same_as<std::optional<T>>;
+            })
+        && requires(const T& index, BinKey key, std::vector<MemoryRegion>& out) {
+               { T::npos } -> std::convertible_to<std::uint32_t>;
+               { index.find(key) } -> std::same_as<std::uint32_t>;
+               index.prefetch(key);
+               { index.memory_usage() } -> std::same_as<std::size_t>;
+               index.memory_regions(out);
+           };
+
+    // A backend that also yields the id of the first key not less than a
+    // given one, so Database::Scan can start from it.
+    template <class T>
+    concept OrderedIndexBackend = IndexBackend<T> && requires(const T& index, BinKey key) {
+        { index.lower_bound(key) } -> std::same_as<std::size_t>;
+    };
+
+    // A backend that resolves longest-prefix matches itself rather than
+    // through one find() per candidate length.
+    template <class T>
+    concept LongestPrefixIndexBackend = IndexBackend<T> && requires(const T& index, BinKey key) {
+        { index.find_longest(key) } -> std::same_as<std::uint32_t>;
+    };
+
+    template <IndexBackend T>
+    [[nodiscard]] auto build_index(std::span<const std::uint32_t> keys) -> std::optional<T> {
+        if constexpr (std::constructible_from<T, std::span<const std::uint32_t>>) {
+            return T(keys);
+        } else {
+            return T::build(keys);
+        }
+    }
+
+    // The shape of a dataset, as far as choosing an index goes.
+    struct DatasetProfile {
+        std::size_t keys = 0;
+        std::size_t six_digit_keys = 0;
+        // 7- and 8-digit keys.
+        std::size_t long_keys = 0;
+        std::size_t ranges = 0;
+        // Loaded from a snapshot file rather than built from CSV, and
+        // whether that snapshot carries a perfect hash.
+        bool snapshot = false;
+        bool stored_perfect_hash = false;
+
+        // `keys` are BinKey::packed values.
+        [[nodiscard]] static auto of(std::span<const std::uint32_t> keys, std::size_t ranges) noexcept
+            -> DatasetProfile;
+    };
+
+    // The index a load uses: options.index unless it is Auto, otherwise the
+    // fastest layout for `data` that respects the load's other options
+    // (see IndexKind::Auto).
+    [[nodiscard]] auto select_index(const DatasetProfile& data, const LoadOptions& options) noexcept -> IndexKind;
+}
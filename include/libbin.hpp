@@ -1,6 +1,8 @@
 #pragma once 
 
+#include "database.hpp"
 #include "lookup.hpp"
+#include "pan.hpp"
 #include "result.hpp"
 #include "errors.hpp"
 #include "version.hpp"
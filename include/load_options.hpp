@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+
+namespace LibBIN {
+    // In-memory index used to resolve a BIN key to its record.
+    enum class IndexKind {
+        // Chosen from the data by select_index (see index_backend.hpp):
+        // Sorted for packed data; Direct when 6-digit BINs fill a quarter of
+        // their space and longer ones are rare; Perfect for snapshots that
+        // store a perfect hash; Sorted when ranges outnumber BINs; then
+        // Hash for CSV loads, and Sorted or, past 65,536 BINs, Tree for
+        // snapshots.
+        Auto,
+        // Swiss-table style flat hash table keyed by the packed integer BIN
+        // (see FlatHashIndex).
+        Hash,
+        // Binary search over the snapshot's sorted key table.
+        Sorted,
+        // Dense 1,000,000-slot table for 6-digit BINs plus a sorted side
+        // table for 7/8-digit BINs.
+        Direct,
+        // Level-compressed digit trie; resolves longest-prefix matches in
+        // one walk instead of one probe per candidate length.
+        Prefix,
+        // Minimal perfect hash (see PerfectHash): one hash, then a pilot,
+        // an id and a key read per probe. Read from snapshots compiled by
+        // bin_compile, built at load time otherwise.
+        Perfect,
+        // Static B+ tree of cache-line nodes (see SearchTree): a couple of
+        // cache misses per probe even for very large key sets, and the
+        // lower bounds that start Database::Scan.
+        Tree,
+    };
+
+    // Page backing for the loaded tables.
+    enum class HugePages {
+        // Whatever the system's THP policy gives.
+        Off,
+        // madvise(MADV_HUGEPAGE) on every table.
+        Transparent,
+        // The snapshot image is copied into reserved hugetlbfs pages
+        // (vm.nr_hugepages); the indexes get transparent huge pages. The
+        // load fails if too few huge pages are reserved.
+        Explicit,
+    };
+
+    struct LoadOptions {
+        IndexKind index = IndexKind::Auto;
+        // Threads parsing CSV input in newline-aligned chunks; 0 uses
+        // std::thread::hardware_concurrency(). Ignored by load_snapshot.
+        unsigned threads = 1;
+        // Overlay entries (see Database::apply_delta) at which a background
+        // compaction is started; 0 leaves compaction to Database::compact().
+        std::size_t compaction_threshold = 65536;
+        // Hold records in the packed layout (see Snapshot::pack): several
+        // times smaller, at the cost of decoding keys and fields on access.
+        // Sorted then searches the packed keys.
+        bool packed = false;
+        // Residency controls, applied before the data is published so the
+        // first lookups neither page-fault nor miss the TLB more than
+        // later ones. `prefault` maps snapshots with MAP_POPULATE and
+        // touches every page of the built tables; `lock_memory` pins them
+        // with mlock and fails the load if RLIMIT_MEMLOCK is too low.
+        HugePages huge_pages = HugePages::Off;
+        bool prefault = false;
+        bool lock_memory = false;
+        // On hosts with several NUMA nodes, build one copy of the base data
+        // and index on each node and serve every lookup from the copy local
+        // to the calling thread's CPU. Costs one copy of the memory per node.
+        bool numa_replicas = false;
+        // Check a NegativeFilter over the base data before its index, so
+        // lookups of BINs that are not present, such as the random BINs of
+        // card-testing traffic, mostly end after one or two cache-resident
+        // reads. Costs 125 KiB, another 125 KiB if there are ranges, plus
+        // about 2 bytes per BIN, and one extra read on hits.
+        bool negative_filter = true;
+    };
+}
@@ -3,18 +3,70 @@
 #include <string_view>
 #include <string>
 #include <expected>
-#include <unordered_map>
+#include <span>
+#include <functional>
 #include "result.hpp"
+#include "result_view.hpp"
 #include "errors.hpp"
+#include "load_options.hpp"
+#include "database.hpp"
 
 namespace LibBIN {
+    // Process-wide facade over a default Database instance, for callers
+    // that need a single dataset. See Database for the loading and view
+    // lifetime rules; load_bins and load_snapshot only load once.
     class Lookup {
         public:
-            static void load_bins(const std::string& csv_path = "/usr/share/LibBIN/bin_data.csv");
-            static auto Search(std::string_view bin) -> std::expected<Result, LookupError>;
+            // Pins the default database; see Database::ReadGuard.
+            class ReadGuard : public Database::ReadGuard {
+                public:
+                    ReadGuard() noexcept : Database::ReadGuard(Lookup::database()) {}
+            };
+
+            // The instance behind the static API.
+            static auto database() noexcept -> Database&;
+
+            static void load_bins(const std::string& csv_path = "/usr/share/LibBIN/bin_data.csv",
+                                  const LoadOptions& options = {});
+            static void load_snapshot(const std::string& snapshot_path = "/usr/share/LibBIN/bin_data.lbin",
+                                      const LoadOptions& options = {});
+            // Rebuilds the database from the source of the last load_bins or
+            // load_snapshot call and publishes it atomically. Lookups keep
+            // running against the old data during the build; on failure it
+            // stays in place. Returns once the old data is freed.
+            static auto reload() -> std::expected<void, LookupError>;
+            // Applies a delta file to the default database; see
+            // Database::apply_delta and Database::compact.
+            static auto apply_delta(const std::string& delta_path) -> std::expected<DeltaStats, LookupError>;
+            static auto compact() -> std::expected<void, LookupError>;
+            static auto Search(std::string_view bin, MatchMode mode = MatchMode::Exact)
+                -> std::expected<Result, LookupError>;
+            // Like Search, but returns a view into the loaded database instead
+            // of copying the record; a hit performs no allocation.
+            static auto SearchView(std::string_view bin, MatchMode mode = MatchMode::Exact)
+                -> std::expected<ResultView, LookupError>;
+            // Non-allocating lookup: hits return a view, misses and malformed
+            // input a compact SearchError whose message is formatted lazily.
+            static auto TrySearch(std::string_view bin, MatchMode mode = MatchMode::Exact) noexcept
+                -> std::expected<ResultView, SearchError>;
+            // TrySearch over many BINs: out[i] receives the result for bins[i]
+            // for the first min(bins.size(), out.size()) entries. Keys are
+            // parsed and their index slots prefetched several entries ahead
+            // so the cache misses of neighbouring lookups overlap.
+            static void SearchBatch(std::span<const std::string_view> bins,
+                                    std::span<std::expected<ResultView, SearchError>> out,
+                                    MatchMode mode = MatchMode::Exact) noexcept;
+            // Card number lookups; see Database::SearchPan.
+            static auto SearchPan(std::string_view pan) -> std::expected<Result, LookupError>;
+            static auto TrySearchPan(std::string_view pan) noexcept -> std::expected<ResultView, SearchError>;
+            static void SearchPanBatch(std::span<const std::string_view> pans,
+                                       std::span<std::expected<ResultView, SearchError>> out) noexcept;
+            // Ordered scan of the default instance; see Database::Scan.
+            static auto Scan(std::string_view first, std::string_view last,
+                             const std::function<void(const ResultView&)>& visit)
+                -> std::expected<std::size_t, SearchError>;
 
         private:
-            static const std::unordered_map<std::string, Result>& get_bin_map();
-        static bool is_valid_bin(std::string_view bin);
+        static bool is_valid_bin(std::string_view bin) noexcept;
     };
 }
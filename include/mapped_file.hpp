@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <expected>
+#include <span>
+#include <string>
+#include "errors.hpp"
+
+namespace LibBIN {
+    // Read-only, private memory mapping of a whole file, or of an anonymous
+    // copy of some bytes.
+    class MappedFile {
+        public:
+            MappedFile() = default;
+            MappedFile(const MappedFile&) = delete;
+            MappedFile& operator=(const MappedFile&) = delete;
+            MappedFile(MappedFile&& other) noexcept;
+            MappedFile& operator=(MappedFile&& other) noexcept;
+            ~MappedFile();
+
+            // With `populate`, every page is faulted in by mmap itself
+            // (MAP_POPULATE) rather than on first access.
+            static auto open(const std::string& path, bool populate = false) -> std::expected<MappedFile, LookupError>;
+            // Copies `bytes` into a fresh anonymous mapping, backed by
+            // explicit huge pages (MAP_HUGETLB) if `huge_pages` is set; that
+            // fails unless the system has enough reserved.
+            static auto copy(std::span<const std::byte> bytes, bool huge_pages) -> std::expected<MappedFile, LookupError>;
+
+            [[nodiscard]] auto data() const noexcept -> const std::byte* { return data_; }
+            [[nodiscard]] auto size() const noexcept -> std::size_t { return size_; }
+            [[nodiscard]] auto bytes() const noexcept -> std::span<const std::byte> { return {data_, size_}; }
+
+        private:
+            void reset() noexcept;
+
+            const std::byte* data_ = nullptr;
+            std::size_t size_ = 0;
+            // Mapped length, size_ rounded up to the page size used.
+            std::size_t length_ = 0;
+    };
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "bin_key.hpp"
+#include "residency.hpp"
+#include "snapshot.hpp"
+
+namespace LibBIN {
+    // Rejects most BINs that cannot match before any index is probed. A
+    // 1,000,000-bit set (125 KiB) marks each 6-digit prefix that has a BIN
+    // or range under it; a prefix whose bit is clear misses in every match
+    // mode. Exact lookups under a marked prefix then ask a split-block Bloom
+    // filter: one 64-byte block per key, one bit set in each of its eight
+    // words, about 2 bytes per key and a false positive rate near 0.5%.
+    // Prefixes a range touches are marked exactly in a second 1,000,000-bit
+    // set, held only when there are ranges, so BINs inside a range always
+    // pass and range spans cost no Bloom space. False positives only cost
+    // the index probe the filter would have saved; no BIN that matches is
+    // ever rejected.
+    class NegativeFilter {
+        public:
+            static constexpr std::size_t prefixes = 1'000'000;
+
+            // An empty filter passes every key.
+            NegativeFilter() = default;
+            // `keys` are BinKey::packed values; `ranges` are the snapshot's ranges.
+            NegativeFilter(std::span<const std::uint32_t> keys, std::span<const SnapshotRange> ranges);
+
+            [[nodiscard]] auto empty() const noexcept -> bool { return prefixes_.empty(); }
+            // False only if no BIN or range matches `key` exactly.
+            [[nodiscard]] auto may_contain(BinKey key) const noexcept -> bool {
+                if (prefixes_.empty()) return true;
+                const std::uint32_t prefix = key.padded() / 100;
+                if (!test(prefixes_, prefix)) return false;
+                return (!ranged_.empty() && test(ranged_, prefix)) || block_contains(key.packed);
+            }
+            // False only if no BIN or range matches a prefix of `key`.
+            [[nodiscard]] auto may_contain_prefix(BinKey key) const noexcept -> bool {
+                return prefixes_.empty() || test(prefixes_, key.padded() / 100);
+            }
+
+            [[nodiscard]] auto memory_usage() const noexcept -> std::size_t;
+            // The blocks counted by memory_usage(), for residency controls.
+            void memory_regions(std::vector<MemoryRegion>& out) const;
+
+        private:
+            struct alignas(64) Block {
+                std::uint64_t words[8];
+            };
+
+            [[nodiscard]] static auto test(const std::vector<std::uint64_t>& bits, std::uint32_t prefix) noexcept -> bool {
+                return (bits[prefix / 64] >> (prefix % 64) & 1u) != 0;
+            }
+            [[nodiscard]] static constexpr auto hash(std::uint32_t key) noexcept -> std::uint64_t {
+                std::uint64_t h = key * 0xff51afd7ed558ccdull;
+                h ^= h >> 33;
+                h *= 0xc4ceb9fe1a85ec53ull;
+                return h ^ (h >> 33);
+            }
+            [[nodiscard]] auto block_of(std::uint64_t h) const noexcept -> std::size_t {
+                return static_cast<std::size_t>((h >> 32) * blocks_.size() >> 32);
+            }
+            // Eight 6-bit word offsets, remixed so they do not repeat the
+            // high bits that picked the block.
+            [[nodiscard]] static constexpr auto bit_positions(std::uint64_t h) noexcept -> std::uint64_t {
+                return h * 0x9e3779b97f4a7c15ull >> 16;
+            }
+            [[nodiscard]] auto block_contains(std::uint32_t key) const noexcept -> bool {
+                const std::uint64_t h = hash(key);
+                const Block& block = blocks_[block_of(h)];
+                const std::uint64_t bits = bit_positions(h);
+                std::uint64_t missing = 0;
+                for (std::size_t i = 0; i < 8; ++i) missing |= ~block.words[i] >> (bits >> (6 * i) & 63);
+                return (missing & 1u) == 0;
+            }
+            void add(std::uint32_t key) noexcept;
+
+            std::vector<std::uint64_t> prefixes_;
+            // Prefixes some range touches; empty without ranges.
+            std::vector<std::uint64_t> ranged_;
+            std::vector<Block> blocks_;
+    };
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace LibBIN {
+    // NUMA topology, read once from /sys/devices/system/node. Hosts without
+    // that information look like a single node 0 holding every CPU.
+    struct NumaTopology {
+        // Online node ids, ascending.
+        std::vector<unsigned> nodes;
+        // Node of each CPU id; CPUs not listed map to node 0.
+        std::vector<unsigned> cpu_node;
+
+        [[nodiscard]] static auto get() -> const NumaTopology&;
+        [[nodiscard]] auto cpus(unsigned node) const -> std::vector<unsigned>;
+    };
+
+    // Node of the CPU the calling thread is running on.
+    [[nodiscard]] auto current_numa_node() noexcept -> unsigned;
+
+    // Restricts the calling thread to `node`'s CPUs and asks the kernel to
+    // prefer `node` for its new allocations. False if the affinity could
+    // not be set; the memory policy is best effort.
+    auto bind_thread_to_numa_node(unsigned node) -> bool;
+}
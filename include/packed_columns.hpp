@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <vector>
+#include "residency.hpp"
+
+namespace LibBIN {
+    // Reads `width` (<= 57) bits starting at bit `bit` of a little-endian
+    // bit stream. The stream must be readable for 8 bytes past the byte
+    // holding `bit`.
+    [[nodiscard]] inline auto read_packed_bits(const std::uint8_t* bytes, std::size_t bit, unsigned width) noexcept
+        -> std::uint64_t {
+        std::uint64_t word;
+        std::memcpy(&word, bytes + bit / 8, sizeof(word));
+        return (word >> (bit % 8)) & ((std::uint64_t{1} << width) - 1);
+    }
+
+    // Rows of small unsigned integers, each column stored at its own fixed
+    // bit width and rows laid end to end, so a row of dictionary ids takes
+    // only as many bits as its dictionaries need.
+    class PackedColumns {
+        public:
+            static constexpr unsigned max_width = 32;
+
+            PackedColumns() = default;
+            // Zero-filled rows; each width is at most max_width.
+            PackedColumns(std::span<const unsigned> widths, std::size_t rows);
+
+            // `value` must fit the column's width.
+            void set(std::size_t row, std::size_t column, std::uint32_t value) noexcept;
+            [[nodiscard]] auto get(std::size_t row, std::size_t column) const noexcept -> std::uint32_t {
+                return static_cast<std::uint32_t>(
+                    read_packed_bits(bits_.data(), row * row_bits_ + offsets_[column], widths_[column]));
+            }
+            void prefetch(std::size_t row) const noexcept {
+                __builtin_prefetch(bits_.data() + row * row_bits_ / 8);
+            }
+
+            [[nodiscard]] auto row_bits() const noexcept -> std::size_t { return row_bits_; }
+            [[nodiscard]] auto memory_usage() const noexcept -> std::size_t;
+            // The blocks counted by memory_usage(), for residency controls.
+            void memory_regions(std::vector<MemoryRegion>& out) const;
+
+        private:
+            std::vector<std::uint8_t> bits_;
+            std::vector<std::uint8_t> widths_;
+            std::vector<std::uint16_t> offsets_;
+            std::size_t row_bits_ = 0;
+    };
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+#include "bin_key.hpp"
+#include "packed_columns.hpp"
+#include "residency.hpp"
+
+namespace LibBIN {
+    // Compressed sorted key table. Keys are cut into blocks of 64; each
+    // block stores its first key in a skip index and the rest as offsets
+    // from it at the narrowest bit width that fits, so a dense dataset
+    // needs two to three bytes per key. A lookup binary-searches the skip
+    // index and then the block's offsets, decoding only the probed ones.
+    // The BINs' digits are kept alongside in key order so a record's BIN
+    // can still be returned as a view.
+    class PackedKeys {
+        public:
+            static constexpr std::uint32_t npos = 0xFFFFFFFFu;
+            static constexpr std::size_t block_keys = 64;
+
+            PackedKeys() = default;
+            // `keys` are sorted BinKey::packed values; a key's id is its position.
+            explicit PackedKeys(std::span<const std::uint32_t> keys);
+
+            [[nodiscard]] auto size() const noexcept -> std::size_t { return size_; }
+            [[nodiscard]] auto find(BinKey key) const noexcept -> std::uint32_t;
+            // Position of the first key not less than `key`; size() if none.
+            [[nodiscard]] auto lower_bound(BinKey key) const noexcept -> std::size_t;
+            [[nodiscard]] auto key(std::size_t id) const noexcept -> BinKey {
+                const Block& block = blocks_[id / block_keys];
+                return BinKey{firsts_[id / block_keys] + offset(block, id % block_keys)};
+            }
+            // The key's digits, as written in the source data.
+            [[nodiscard]] auto text(std::size_t id) const noexcept -> std::string_view {
+                const Block& block = blocks_[id / block_keys];
+                const std::size_t j = id % block_keys;
+                const std::uint64_t below = (std::uint64_t{1} << j) - 1;
+                std::size_t start = block.text + BinKey::min_digits * j
+                                  + static_cast<std::size_t>(__builtin_popcountll(block.seven & below))
+                                  + 2 * static_cast<std::size_t>(__builtin_popcountll(block.eight & below));
+                std::size_t length = BinKey::min_digits + ((block.seven >> j) & 1) + 2 * ((block.eight >> j) & 1);
+                return {text_.data() + start, length};
+            }
+            [[nodiscard]] auto memory_usage() const noexcept -> std::size_t;
+            // The blocks counted by memory_usage(), for residency controls.
+            void memory_regions(std::vector<MemoryRegion>& out) const;
+
+        private:
+            struct Block {
+                // Byte offset of the block's packed offsets in offsets_.
+                std::uint32_t bytes = 0;
+                // Offset of the block's first key's digits in text_.
+                std::uint32_t text = 0;
+                // Keys with seven and with eight digits, by position.
+                std::uint64_t seven = 0;
+                std::uint64_t eight = 0;
+                std::uint8_t width = 0;
+            };
+
+            [[nodiscard]] auto offset(const Block& block, std::size_t j) const noexcept -> std::uint32_t {
+                return static_cast<std::uint32_t>(
+                    read_packed_bits(offsets_.data() + block.bytes, j * block.width, block.width));
+            }
+
+            std::vector<std::uint32_t> firsts_;
+            std::vector<Block> blocks_;
+            std::vector<std::uint8_t> offsets_;
+            std::vector<char> text_;
+            std::size_t size_ = 0;
+    };
+}
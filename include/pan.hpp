@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <expected>
+#include <span>
+#include <string_view>
+#include "bin_key.hpp"
+#include "errors.hpp"
+
+namespace LibBIN {
+    // A primary account number has 12-19 digits; spaces and dashes between
+    // them are ignored.
+    inline constexpr std::size_t pan_min_digits = 12;
+    inline constexpr std::size_t pan_max_digits = 19;
+
+    // True if `digits` are all decimal digits and pass the Luhn (mod 10)
+    // check. Up to 32 digits are checked with one vector pass: the digits
+    // to double are picked by a fixed mask and doubled through a shuffle
+    // table, and the sum is taken with a single sad.
+    [[nodiscard]] auto luhn_valid(std::string_view digits) noexcept -> bool;
+    [[nodiscard]] auto luhn_valid(std::string_view digits, SimdLevel level) noexcept -> bool;
+
+    // Strips separators, checks the digit count and the Luhn checksum, and
+    // returns the 8-digit key of the PAN's leading digits, to be resolved
+    // with MatchMode::LongestPrefix. Fails with InvalidFormat or
+    // InvalidChecksum. Nothing is allocated.
+    [[nodiscard]] auto parse_pan(std::string_view pan) noexcept -> std::expected<BinKey, ErrorCode>;
+    [[nodiscard]] auto parse_pan(std::string_view pan, SimdLevel level) noexcept -> std::expected<BinKey, ErrorCode>;
+    // Parses pans[i] into out[i] for the first min(pans.size(), out.size()) entries.
+    void parse_pans(std::span<const std::string_view> pans, std::span<std::expected<BinKey, ErrorCode>> out) noexcept;
+
+    // The part of a PAN that errors may echo: at most its first six
+    // characters, so a card number is never carried into logs.
+    [[nodiscard]] constexpr auto pan_error_input(std::string_view pan) noexcept -> std::string_view {
+        return pan.substr(0, BinKey::min_digits);
+    }
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+#include "bin_key.hpp"
+#include "residency.hpp"
+
+namespace LibBIN {
+    // Minimal perfect hash over a fixed set of BinKeys, built PTHash-style:
+    // keys are hashed into buckets of about four, and each bucket gets a
+    // 16-bit pilot that sends all of its keys to free positions. Buckets are
+    // placed largest first over a table 3% larger than the key count;
+    // positions past the end are remapped to the free slots below it, so
+    // the id table holds exactly one entry per key. The function itself
+    // costs about five bits per key. Keys stay in sorted order in the key
+    // table, so each position also needs its 4-byte record id; a lookup is
+    // one hash, one pilot read, one id read and one key table read that
+    // verifies the key.
+    //
+    // A hash is either built in memory or a view over the serialized form
+    // stored in a snapshot. Either way it reads the key table it was given,
+    // and a view reads the snapshot, which must outlive it.
+    class PerfectHash {
+        public:
+            static constexpr std::uint32_t npos = 0xFFFFFFFFu;
+
+            // Serialized layout: this header, the pilots padded to four
+            // bytes, the remap table for positions past slot_count, then
+            // the record id at each position.
+            struct Header {
+                std::uint64_t seed;
+                std::uint32_t bucket_count;
+                std::uint32_t table_size;
+                std::uint32_t slot_count;
+                std::uint32_t reserved;
+            };
+
+            PerfectHash() = default;
+            PerfectHash(PerfectHash&&) noexcept = default;
+            PerfectHash& operator=(PerfectHash&&) noexcept = default;
+            PerfectHash(const PerfectHash&) = delete;
+            PerfectHash& operator=(const PerfectHash&) = delete;
+
+            // `keys` are distinct BinKey::packed values; a key's record id is
+            // its position. The hash keeps reading `keys`, which must outlive
+            // it. Fails only if no seed out of several places every bucket.
+            [[nodiscard]] static auto build(std::span<const std::uint32_t> keys) -> std::optional<PerfectHash>;
+            // Views a serialized hash over `keys`; nullopt if the bytes are
+            // malformed or do not cover exactly that many keys.
+            [[nodiscard]] static auto view(std::span<const std::byte> bytes, std::span<const std::uint32_t> keys)
+                -> std::optional<PerfectHash>;
+            [[nodiscard]] auto serialize() const -> std::vector<std::byte>;
+
+            [[nodiscard]] auto empty() const noexcept -> bool { return slot_count_ == 0; }
+            [[nodiscard]] auto size() const noexcept -> std::size_t { return slot_count_; }
+            [[nodiscard]] auto find(BinKey key) const noexcept -> std::uint32_t {
+                if (slot_count_ == 0) return npos;
+                const std::uint64_t h = hash(key.packed, seed_);
+                std::size_t p = position(h, pilots_[bucket(h, bucket_count_)], table_size_);
+                if (p >= slot_count_) p = remap_[p - slot_count_];
+                const std::uint32_t id = ids_[p];
+                return keys_[id] == key.packed ? id : npos;
+            }
+            // Starts loading the pilot `find(key)` will read first.
+            void prefetch(BinKey key) const noexcept {
+                if (slot_count_ != 0) __builtin_prefetch(&pilots_[bucket(hash(key.packed, seed_), bucket_count_)]);
+            }
+
+            // Bytes built in memory; a view's bytes belong to its snapshot.
+            [[nodiscard]] auto memory_usage() const noexcept -> std::size_t;
+            // The blocks counted by memory_usage(), for residency controls.
+            void memory_regions(std::vector<MemoryRegion>& out) const;
+
+        private:
+            [[nodiscard]] static constexpr auto mix(std::uint64_t x) noexcept -> std::uint64_t {
+                x ^= x >> 30;
+                x *= 0xbf58476d1ce4e5b9ull;
+                x ^= x >> 27;
+                x *= 0x94d049bb133111ebull;
+                return x ^ (x >> 31);
+            }
+            // Maps a 64-bit hash onto [0, n) without a division.
+            [[nodiscard]] static constexpr auto reduce(std::uint64_t h, std::size_t n) noexcept -> std::size_t {
+                return static_cast<std::size_t>((static_cast<unsigned __int128>(h) * n) >> 64);
+            }
+            [[nodiscard]] static constexpr auto hash(std::uint32_t key, std::uint64_t seed) noexcept -> std::uint64_t {
+                return mix(key ^ seed);
+            }
+            [[nodiscard]] static constexpr auto bucket(std::uint64_t h, std::size_t buckets) noexcept -> std::size_t {
+                return reduce(h, buckets);
+            }
+            [[nodiscard]] static constexpr auto position(std::uint64_t h, std::uint16_t pilot, std::size_t table_size) noexcept
+                -> std::size_t {
+                return reduce(mix(h ^ (pilot * 0x9e3779b97f4a7c15ull)), table_size);
+            }
+
+            std::uint64_t seed_ = 0;
+            std::size_t bucket_count_ = 0;
+            std::size_t table_size_ = 0;
+            std::size_t slot_count_ = 0;
+            const std::uint16_t* pilots_ = nullptr;
+            const std::uint32_t* remap_ = nullptr;
+            const std::uint32_t* ids_ = nullptr;
+            std::span<const std::uint32_t> keys_;
+
+            // Storage of a built hash; the pointers above then point into these.
+            std::vector<std::uint16_t> owned_pilots_;
+            std::vector<std::uint32_t> owned_remap_;
+            std::vector<std::uint32_t> owned_ids_;
+    };
+
+    static_assert(sizeof(PerfectHash::Header) == 24);
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "bin_key.hpp"
+#include "residency.hpp"
+
+namespace LibBIN {
+    // Level-compressed digit trie for longest-prefix matching of 6-8 digit
+    // BINs. The first six digits are consumed by one direct-addressed level;
+    // digits seven and eight each descend one 10-way node. A slot holds
+    // either a record id (no longer BINs below it) or node_bit | node index,
+    // where the node carries the record id of the BIN it represents, so a
+    // query resolves its most specific match in a single walk.
+    class PrefixIndex {
+        public:
+            static constexpr std::uint32_t npos = 0xFFFFFFFFu;
+
+            PrefixIndex() = default;
+            // `keys` are sorted BinKey::packed values; a key's record id is its position.
+            explicit PrefixIndex(std::span<const std::uint32_t> keys);
+
+            [[nodiscard]] auto find(BinKey key) const noexcept -> std::uint32_t;
+            [[nodiscard]] auto find_longest(BinKey key) const noexcept -> std::uint32_t;
+            // Starts loading the root slot both finds begin from.
+            void prefetch(BinKey key) const noexcept {
+                if (!root_.empty()) __builtin_prefetch(&root_[key.padded() / 100]);
+            }
+            [[nodiscard]] auto memory_usage() const noexcept -> std::size_t;
+            // The blocks counted by memory_usage(), for residency controls.
+            void memory_regions(std::vector<MemoryRegion>& out) const;
+
+        private:
+            static constexpr std::uint32_t node_bit = 0x80000000u;
+
+            struct Node {
+                std::uint32_t self = npos;
+                std::array<std::uint32_t, 10> slots;
+            };
+
+            [[nodiscard]] auto descend(std::uint32_t& slot) -> Node&;
+
+            std::vector<std::uint32_t> root_;
+            std::vector<Node> nodes_;
+    };
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "bin_key.hpp"
+#include "snapshot.hpp"
+#include "residency.hpp"
+
+namespace LibBIN {
+    // Interval index over sorted, non-overlapping account ranges. Range
+    // starts are kept in their own array and searched without branches on
+    // the comparison, so a lookup costs log2(ranges) predictable steps no
+    // matter how many BINs the ranges span.
+    class RangeIndex {
+        public:
+            static constexpr std::uint32_t npos = 0xFFFFFFFFu;
+
+            RangeIndex() = default;
+            // Range i resolves to record id `first_id + i`.
+            RangeIndex(std::span<const SnapshotRange> ranges, std::uint32_t first_id);
+
+            [[nodiscard]] auto empty() const noexcept -> bool { return firsts_.empty(); }
+            // Record id of the range containing every 8-digit value under `key`.
+            [[nodiscard]] auto find(BinKey key) const noexcept -> std::uint32_t {
+                if (firsts_.empty()) return npos;
+                const std::uint32_t* base = firsts_.data();
+                std::size_t n = firsts_.size();
+                while (n > 1) {
+                    std::size_t half = n / 2;
+                    base = base[half] <= key.padded() ? base + half : base;
+                    n -= half;
+                }
+                std::size_t i = static_cast<std::size_t>(base - firsts_.data());
+                if (*base > key.padded() || key.padded_last() > lasts_[i]) return npos;
+                return first_id_ + static_cast<std::uint32_t>(i);
+            }
+            [[nodiscard]] auto memory_usage() const noexcept -> std::size_t;
+            // The blocks counted by memory_usage(), for residency controls.
+            void memory_regions(std::vector<MemoryRegion>& out) const;
+
+        private:
+            std::vector<std::uint32_t> firsts_;
+            std::vector<std::uint32_t> lasts_;
+            std::uint32_t first_id_ = 0;
+    };
+}
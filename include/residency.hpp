@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <expected>
+#include <span>
+#include <vector>
+#include "errors.hpp"
+
+namespace LibBIN {
+    // A contiguous block of memory held by a loaded database.
+    using MemoryRegion = std::span<const std::byte>;
+
+    template <class T>
+    [[nodiscard]] auto memory_region(const std::vector<T>& values) noexcept -> MemoryRegion {
+        return std::as_bytes(std::span(values));
+    }
+
+    // Asks the kernel to back the 2 MiB-aligned interior of each region with
+    // transparent huge pages. Advisory: ignored where THP is disabled.
+    void advise_huge_pages(std::span<const MemoryRegion> regions) noexcept;
+    // Faults every page of each region in now, so the first lookups do not.
+    void prefault(std::span<const MemoryRegion> regions) noexcept;
+    // Pins the regions in RAM. Fails, with the regions unlocked again, if
+    // RLIMIT_MEMLOCK or the privileges of the process do not allow it.
+    auto lock_memory(std::span<const MemoryRegion> regions) -> std::expected<void, LookupError>;
+    // Unlocks only the pages lying wholly inside a region, so pages shared
+    // with another locked database stay locked.
+    void unlock_memory(std::span<const MemoryRegion> regions) noexcept;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+#include "result.hpp"
+#include "snapshot.hpp"
+
+namespace LibBIN {
+    // Non-owning view of one record. Accessors return string_views into the
+    // database the view came from, so looking up and reading a record does
+    // not allocate. A view stays valid while the data it was found in is
+    // current, or while a ReadGuard taken before the lookup is held (see
+    // Database); call to_result() to keep the data beyond that.
+    class ResultView {
+        public:
+            ResultView() = default;
+            ResultView(const Snapshot* snapshot, std::uint32_t id) noexcept : snapshot_(snapshot), id_(id) {}
+
+            [[nodiscard]] auto bin() const noexcept -> std::string_view { return snapshot_->bin(id_); }
+            [[nodiscard]] auto scheme() const noexcept -> std::string_view { return get(RecordField::Scheme); }
+            [[nodiscard]] auto type() const noexcept -> std::string_view { return get(RecordField::Type); }
+            [[nodiscard]] auto brand() const noexcept -> std::string_view { return get(RecordField::Brand); }
+            [[nodiscard]] auto bank() const noexcept -> std::string_view { return get(RecordField::Bank); }
+            [[nodiscard]] auto country() const noexcept -> std::string_view { return get(RecordField::Country); }
+            [[nodiscard]] auto country_code() const noexcept -> std::string_view { return get(RecordField::CountryCode); }
+            [[nodiscard]] auto level() const noexcept -> std::string_view { return get(RecordField::Level); }
+            [[nodiscard]] auto country_flag() const noexcept -> std::string_view { return get(RecordField::CountryFlag); }
+            [[nodiscard]] auto prepaid() const noexcept -> bool { return (snapshot_->flags(id_) & snapshot_prepaid) != 0; }
+            [[nodiscard]] auto is_valid() const noexcept -> bool { return (snapshot_->flags(id_) & snapshot_valid) != 0; }
+
+            // Record id within the snapshot the view points into: the base
+            // data or, for records upserted by a delta, the overlay.
+            [[nodiscard]] auto id() const noexcept -> std::uint32_t { return id_; }
+            [[nodiscard]] auto to_result() const -> Result { return snapshot_->record(id_); }
+            void prefetch() const noexcept { snapshot_->prefetch(id_); }
+
+        private:
+            [[nodiscard]] auto get(RecordField field) const noexcept -> std::string_view {
+                return snapshot_->field(id_, field);
+            }
+
+            const Snapshot* snapshot_ = nullptr;
+            std::uint32_t id_ = 0;
+    };
+
+    static_assert(std::is_trivially_copyable_v<ResultView>);
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "bin_key.hpp"
+#include "residency.hpp"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace LibBIN {
+    // Static B+ tree over sorted keys, each node one 64-byte cache line of
+    // sixteen keys. Leaves hold the keys themselves in order; an inner node
+    // holds the smallest key of its 2nd..17th children. A search counts the
+    // node's keys below the target with vector compares instead of
+    // branching, so it reads one line per level: three for a million keys,
+    // five for a hundred million, with the upper levels staying in cache.
+    // Since a key's position in the leaves is its record id, lower_bound()
+    // also starts ordered scans.
+    class SearchTree {
+        public:
+            static constexpr std::uint32_t npos = 0xFFFFFFFFu;
+            static constexpr std::size_t node_keys = 16;
+            static constexpr std::size_t fanout = node_keys + 1;
+
+            SearchTree() = default;
+            // `keys` are sorted BinKey::packed values; a key's id is its position.
+            explicit SearchTree(std::span<const std::uint32_t> keys);
+
+            [[nodiscard]] auto size() const noexcept -> std::size_t { return size_; }
+            // Position of the first key not less than `key`; size() if none.
+            [[nodiscard]] auto lower_bound(BinKey key) const noexcept -> std::size_t {
+                if (size_ == 0) return 0;
+                const auto target = static_cast<std::int32_t>(key.packed);
+                std::size_t k = 0;
+                for (std::size_t level = 0; level + 1 < levels_.size(); ++level) {
+                    k = k * fanout + count_less(nodes_[levels_[level] + k], target);
+                }
+                return k * node_keys + count_less(nodes_[levels_.back() + k], target);
+            }
+            [[nodiscard]] auto find(BinKey key) const noexcept -> std::uint32_t {
+                std::size_t id = lower_bound(key);
+                if (id == size_ || this->key(id) != key.packed) return npos;
+                return static_cast<std::uint32_t>(id);
+            }
+            [[nodiscard]] auto key(std::size_t id) const noexcept -> std::uint32_t {
+                return static_cast<std::uint32_t>(nodes_[levels_.back() + id / node_keys].keys[id % node_keys]);
+            }
+            // Walks the inner levels, which stay cache-resident for all but
+            // huge key sets, and starts loading the leaf `find(key)` ends on.
+            void prefetch(BinKey key) const noexcept;
+
+            [[nodiscard]] auto memory_usage() const noexcept -> std::size_t;
+            // The blocks counted by memory_usage(), for residency controls.
+            void memory_regions(std::vector<MemoryRegion>& out) const;
+
+        private:
+            // Keys are compared as signed 32-bit values: packed keys stay
+            // below 2^31, and the padding sorts after all of them.
+            static constexpr std::int32_t padding = 0x7FFFFFFF;
+
+            struct alignas(64) Node {
+                std::int32_t keys[node_keys];
+            };
+
+            [[nodiscard]] static auto count_less(const Node& node, std::int32_t target) noexcept -> std::size_t {
+#if defined(__SSE2__)
+                const __m128i x = _mm_set1_epi32(target);
+                const auto* keys = reinterpret_cast<const __m128i*>(node.keys);
+                const __m128i low = _mm_packs_epi32(_mm_cmpgt_epi32(x, _mm_load_si128(keys)),
+                                                    _mm_cmpgt_epi32(x, _mm_load_si128(keys + 1)));
+                const __m128i high = _mm_packs_epi32(_mm_cmpgt_epi32(x, _mm_load_si128(keys + 2)),
+                                                     _mm_cmpgt_epi32(x, _mm_load_si128(keys + 3)));
+                return static_cast<std::size_t>(__builtin_popcount(_mm_movemask_epi8(_mm_packs_epi16(low, high))));
+#else
+                std::size_t count = 0;
+                for (std::int32_t k : node.keys) count += k < target;
+                return count;
+#endif
+            }
+
+            // Levels root first, leaves last; levels_[i] is the first node of level i.
+            std::vector<Node> nodes_;
+            std::vector<std::size_t> levels_;
+            std::size_t size_ = 0;
+    };
+}
@@ -0,0 +1,326 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "bin_key.hpp"
+#include "errors.hpp"
+#include "mapped_file.hpp"
+#include "packed_columns.hpp"
+#include "packed_keys.hpp"
+#include "perfect_hash.hpp"
+#include "result.hpp"
+
+namespace LibBIN {
+    // On-disk layout of a .lbin snapshot. All integers are little-endian and
+    // every offset is relative to the start of the file, so the image can be
+    // mapped at any address and served without fix-ups.
+    //
+    //   SnapshotHeader
+    //   SnapshotSection[section_count]
+    //   sections, each aligned to snapshot_alignment
+    //
+    // Readers skip section tags they do not know; a change to an existing
+    // section's layout bumps snapshot_version.
+    inline constexpr char snapshot_magic[4] = {'L', 'B', 'I', 'N'};
+    inline constexpr std::uint16_t snapshot_version = 4;
+    inline constexpr std::size_t snapshot_alignment = 64;
+
+    constexpr auto snapshot_tag(const char (&name)[5]) noexcept -> std::uint32_t {
+        return static_cast<std::uint32_t>(static_cast<unsigned char>(name[0]))
+            | static_cast<std::uint32_t>(static_cast<unsigned char>(name[1])) << 8
+            | static_cast<std::uint32_t>(static_cast<unsigned char>(name[2])) << 16
+            | static_cast<std::uint32_t>(static_cast<unsigned char>(name[3])) << 24;
+    }
+
+    // Sorted BinKey::packed values; key i belongs to record i.
+    inline constexpr std::uint32_t snapshot_keys_tag = snapshot_tag("KEYS");
+    // SnapshotRange values sorted by `first` and non-overlapping; range i
+    // belongs to record key_count + i.
+    inline constexpr std::uint32_t snapshot_ranges_tag = snapshot_tag("RNGS");
+    // SnapshotRecord per key, then per range.
+    inline constexpr std::uint32_t snapshot_records_tag = snapshot_tag("RECS");
+    // SnapshotDictionary per RecordField, then the SnapshotString values of
+    // all dictionaries back to back.
+    inline constexpr std::uint32_t snapshot_dictionaries_tag = snapshot_tag("DICT");
+    // Deduplicated string bytes referenced by SnapshotString.
+    inline constexpr std::uint32_t snapshot_strings_tag = snapshot_tag("STRS");
+    // Optional serialized PerfectHash over the key table, written by
+    // bin_compile (see SnapshotWriter::store_perfect_hash).
+    inline constexpr std::uint32_t snapshot_perfect_hash_tag = snapshot_tag("PHSH");
+
+    // Record attributes stored as ids into a per-field dictionary.
+    enum class RecordField : std::uint8_t {
+        Scheme,
+        Type,
+        Brand,
+        Bank,
+        Country,
+        CountryCode,
+        Level,
+        CountryFlag,
+    };
+    inline constexpr std::size_t record_field_count = 8;
+
+    struct SnapshotHeader {
+        char magic[4];
+        std::uint16_t version;
+        std::uint16_t section_count;
+        std::uint32_t record_count;
+        std::uint32_t reserved;
+        std::uint64_t file_size;
+    };
+
+    struct SnapshotSection {
+        std::uint32_t tag;
+        std::uint32_t reserved;
+        std::uint64_t offset;
+        std::uint64_t size;
+    };
+
+    struct SnapshotRange {
+        std::uint32_t first;
+        std::uint32_t last;
+    };
+
+    struct SnapshotString {
+        std::uint32_t offset;
+        std::uint32_t size;
+    };
+
+    enum SnapshotFlags : std::uint32_t {
+        snapshot_prepaid = 1u << 0,
+        snapshot_valid = 1u << 1,
+    };
+
+    struct SnapshotDictionary {
+        std::uint32_t first;
+        std::uint32_t count;
+    };
+
+    // Low-cardinality fields use 16-bit dictionary ids; bank names get 32.
+    struct SnapshotRecord {
+        SnapshotString bin;
+        std::uint32_t bank;
+        std::uint16_t scheme;
+        std::uint16_t type;
+        std::uint16_t brand;
+        std::uint16_t country;
+        std::uint16_t country_code;
+        std::uint16_t level;
+        std::uint16_t country_flag;
+        std::uint16_t flags;
+
+        [[nodiscard]] constexpr auto id(RecordField field) const noexcept -> std::uint32_t {
+            switch (field) {
+                case RecordField::Scheme: return scheme;
+                case RecordField::Type: return type;
+                case RecordField::Brand: return brand;
+                case RecordField::Bank: return bank;
+                case RecordField::Country: return country;
+                case RecordField::CountryCode: return country_code;
+                case RecordField::Level: return level;
+                case RecordField::CountryFlag: return country_flag;
+            }
+            return 0;
+        }
+    };
+
+    static_assert(sizeof(SnapshotHeader) == 24);
+    static_assert(sizeof(SnapshotSection) == 24);
+    static_assert(sizeof(SnapshotRange) == 8);
+    static_assert(sizeof(SnapshotDictionary) == 8);
+    static_assert(sizeof(SnapshotRecord) == 28);
+
+    // Read-only view over a snapshot image, either mapped from a file or held
+    // in memory. Opening validates the header and section bounds only; records
+    // are decoded on access. Record ids are positions in the sorted key table,
+    // followed by positions in the range table offset by the key count.
+    //
+    // pack() converts a loaded snapshot to a compact in-memory layout: keys
+    // in PackedKeys, record fields as bit-packed dictionary ids, and only
+    // the strings still referenced copied out of the image, which is then
+    // released. Lookups and accessors behave the same in either layout.
+    class Snapshot {
+        public:
+            // `populate` faults the whole mapping in up front (MAP_POPULATE).
+            static auto open(const std::string& path, bool populate = false) -> std::expected<Snapshot, LookupError>;
+            static auto from_image(std::vector<std::byte> image) -> std::expected<Snapshot, LookupError>;
+
+            // Number of records: one per key plus one per range.
+            [[nodiscard]] auto size() const noexcept -> std::size_t { return count_; }
+            // Bytes of the mapped or in-memory image; 0 once packed.
+            [[nodiscard]] auto image_size() const noexcept -> std::size_t { return image_size_; }
+            // Bytes held in either layout.
+            [[nodiscard]] auto memory_usage() const noexcept -> std::size_t;
+            [[nodiscard]] auto packed() const noexcept -> bool { return packed_; }
+            [[nodiscard]] auto key_count() const noexcept -> std::size_t { return key_count_; }
+            // The raw key table; empty once packed.
+            [[nodiscard]] auto keys() const noexcept -> std::span<const std::uint32_t> {
+                return {keys_, packed_ ? 0 : key_count_};
+            }
+            [[nodiscard]] auto ranges() const noexcept -> std::span<const SnapshotRange> { return {ranges_, range_count_}; }
+            [[nodiscard]] auto key(std::size_t index) const noexcept -> BinKey {
+                return packed_ ? packed_keys_.key(index) : BinKey{keys_[index]};
+            }
+            [[nodiscard]] auto find(BinKey key) const noexcept -> std::optional<std::uint32_t>;
+            // Position of the first key not less than `key`; key_count() if none.
+            [[nodiscard]] auto lower_bound(BinKey key) const noexcept -> std::size_t;
+            // The perfect hash stored with the keys; empty if the image has
+            // none, and once packed.
+            [[nodiscard]] auto perfect_hash() const noexcept -> const PerfectHash& { return perfect_hash_; }
+            [[nodiscard]] auto record(std::uint32_t index) const -> Result;
+            [[nodiscard]] auto bin(std::uint32_t index) const noexcept -> std::string_view {
+                if (!packed_) return string(records_[index].bin);
+                if (index < key_count_) return packed_keys_.text(index);
+                return string(range_bins_[index - key_count_]);
+            }
+            [[nodiscard]] auto field(std::uint32_t index, RecordField field) const noexcept -> std::string_view {
+                return dictionary_value(field, packed_ ? packed_records_.get(index, static_cast<std::size_t>(field))
+                                                       : records_[index].id(field));
+            }
+            [[nodiscard]] auto flags(std::uint32_t index) const noexcept -> std::uint32_t {
+                return packed_ ? packed_records_.get(index, record_field_count) : records_[index].flags;
+            }
+            void prefetch(std::uint32_t index) const noexcept {
+                if (packed_) {
+                    packed_records_.prefetch(index);
+                } else {
+                    __builtin_prefetch(&records_[index]);
+                }
+            }
+            // Switches to the packed layout; a no-op if already packed.
+            void pack();
+            // Copies the image into fresh anonymous memory, first touched by
+            // the calling thread; backed by explicit huge pages if asked
+            // (see MappedFile::copy). Packed snapshots cannot be copied.
+            [[nodiscard]] auto copy(bool huge_pages = false) const -> std::expected<Snapshot, LookupError>;
+            // Moves the image into explicit huge pages; a no-op once packed.
+            // On failure the snapshot is unchanged.
+            auto move_to_huge_pages() -> std::expected<void, LookupError>;
+            // The blocks counted by memory_usage(), for residency controls.
+            void memory_regions(std::vector<MemoryRegion>& out) const;
+            // Number of distinct values stored for `field`.
+            [[nodiscard]] auto dictionary_size(RecordField field) const noexcept -> std::size_t {
+                return dictionaries_[static_cast<std::size_t>(field)].count;
+            }
+            [[nodiscard]] auto dictionary_value(RecordField field, std::uint32_t id) const noexcept -> std::string_view {
+                const SnapshotDictionary& dict = dictionaries_[static_cast<std::size_t>(field)];
+                if (id >= dict.count) return {};
+                return string(dictionary_values_[dict.first + id]);
+            }
+
+        private:
+            [[nodiscard]] static auto parse(std::span<const std::byte> image, std::string_view name)
+                -> std::expected<Snapshot, LookupError>;
+            [[nodiscard]] auto string(SnapshotString ref) const noexcept -> std::string_view {
+                if (ref.offset > strings_size_ || ref.size > strings_size_ - ref.offset) return {};
+                return {strings_ + ref.offset, ref.size};
+            }
+
+            MappedFile file_;
+            std::vector<std::byte> image_;
+            const std::uint32_t* keys_ = nullptr;
+            const SnapshotRange* ranges_ = nullptr;
+            const SnapshotRecord* records_ = nullptr;
+            std::array<SnapshotDictionary, record_field_count> dictionaries_{};
+            const SnapshotString* dictionary_values_ = nullptr;
+            const char* strings_ = nullptr;
+            std::size_t count_ = 0;
+            std::size_t key_count_ = 0;
+            std::size_t range_count_ = 0;
+            std::size_t strings_size_ = 0;
+            std::size_t image_size_ = 0;
+            PerfectHash perfect_hash_;
+
+            // Packed layout; the pointers above then point into these.
+            bool packed_ = false;
+            PackedKeys packed_keys_;
+            PackedColumns packed_records_;
+            std::vector<SnapshotRange> packed_ranges_;
+            std::vector<SnapshotString> packed_values_;
+            std::vector<SnapshotString> range_bins_;
+            std::vector<char> packed_strings_;
+    };
+
+    // The fields of one record as views, for adding rows without building a
+    // Result. The views only need to stay valid for the duration of add().
+    struct RecordFields {
+        std::string_view bin;
+        std::string_view scheme;
+        std::string_view type;
+        std::string_view brand;
+        std::string_view bank;
+        std::string_view country;
+        std::string_view country_code;
+        std::string_view level;
+        std::string_view country_flag;
+        bool prepaid = false;
+        bool is_valid = true;
+    };
+
+    // Collects records and serializes them into the snapshot layout. Field
+    // values are interned as records are added, so each distinct value is
+    // copied once; values only used by records that are later dropped stay
+    // in the dictionaries. Records are sorted by key; for duplicate BINs or identical
+    // ranges the last one added wins. A range overlapping an earlier-starting
+    // range is dropped.
+    class SnapshotWriter {
+        public:
+            // Returns false, and keeps nothing, if the bin is neither a 6-8
+            // digit BIN nor a BinRange.
+            auto add(const Result& result) -> bool;
+            auto add(const RecordFields& fields) -> bool;
+            // Stable-sorts the records added so far by key. Sorted writers
+            // merge in linear time and skip the sort in serialize().
+            void sort();
+            // Moves every record of `other` after this writer's records, as if
+            // they had been added here, remapping its dictionary ids.
+            void merge(SnapshotWriter&& other);
+            // Also builds a PerfectHash over the keys and stores it in the
+            // image, so loading the snapshot needs no index build.
+            void store_perfect_hash(bool enabled) noexcept { perfect_hash_ = enabled; }
+            // Number of records held; drops to the deduplicated count once serialized.
+            [[nodiscard]] auto size() const noexcept -> std::size_t { return entries_.size() + ranges_.size(); }
+            // Ranges discarded by the last serialize() for overlapping another range.
+            [[nodiscard]] auto overlapping_ranges() const noexcept -> std::size_t { return overlapping_ranges_; }
+            // Fails if a 16-bit dictionary field has more than 65536 distinct values.
+            [[nodiscard]] auto serialize() -> std::expected<std::vector<std::byte>, LookupError>;
+            auto write(const std::string& path) -> std::expected<void, LookupError>;
+
+        private:
+            // Interned bytes live in fixed blocks so the views used as map keys
+            // stay valid as the pool grows; offsets are into the concatenation.
+            struct StringBlock {
+                std::unique_ptr<char[]> data;
+                std::size_t size = 0;
+                std::size_t capacity = 0;
+            };
+
+            auto encode(const RecordFields& fields) -> SnapshotRecord;
+            auto encode_field(RecordField field, std::string_view text) -> std::uint32_t;
+            auto intern(std::string_view text) -> SnapshotString;
+            auto append(std::string_view text) -> SnapshotString;
+            [[nodiscard]] auto stored(SnapshotString ref) const noexcept -> std::string_view;
+
+            std::vector<std::pair<BinKey, SnapshotRecord>> entries_;
+            std::vector<std::pair<BinRange, SnapshotRecord>> ranges_;
+            std::vector<StringBlock> blocks_;
+            std::size_t pool_size_ = 0;
+            std::unordered_map<std::string_view, std::uint32_t> interned_;
+            std::array<std::vector<SnapshotString>, record_field_count> values_;
+            std::array<std::unordered_map<std::string_view, std::uint32_t>, record_field_count> ids_;
+            std::array<std::pair<std::string_view, std::uint32_t>, record_field_count> last_ids_{};
+            std::size_t overlapping_ranges_ = 0;
+            bool perfect_hash_ = false;
+    };
+}
@@ -1,4 +1,5 @@
 #include <iostream>
+#include <cstdlib>
 #include <fstream>
 #include <string>
 #include <vector>
@@ -15,8 +16,13 @@ enum class OutputFormat {
 
 struct CLIOptions {
     std::string bin;
+    std::string pan;
     std::string file_input;
     std::string output_file;
+    std::string snapshot;
+    std::string delta;
+    LibBIN::LoadOptions load;
+    LibBIN::MatchMode match = LibBIN::MatchMode::Exact;
     OutputFormat format = OutputFormat::Pretty;
     bool color = true;
     bool quiet = false;
@@ -28,8 +34,19 @@ void print_usage(const char* prog) {
     std::cout << "Usage: " << prog << " [options]\n"
               << "Options:\n"
               << "  --bin <BIN>           Lookup a single BIN\n"
+              << "  --pan <number>        Lookup the BIN of a full card number (Luhn-checked)\n"
               << "  --file <filename>     Lookup multiple BINs from file\n"
               << "  --output <filename>   Write output to file\n"
+              << "  --snapshot <file>     Load a .lbin snapshot built by bin_compile instead of the CSV\n"
+              << "  --index <type>        Index: auto, hash, sorted, direct, prefix, perfect, tree (default: auto)\n"
+              << "  --threads <n>         CSV parsing threads, 0 for all cores (default: 1)\n"
+              << "  --packed              Hold records in the compact packed layout\n"
+              << "  --huge-pages <mode>   Huge page backing: off, transparent, explicit (default: off)\n"
+              << "  --prefault            Fault the database into memory before serving\n"
+              << "  --mlock               Lock the database in memory\n"
+              << "  --no-negative-filter  Skip the filter that turns away absent BINs early\n"
+              << "  --delta <file>        Apply a delta file (op,bin,... rows) after loading\n"
+              << "  --longest             Fall back to the longest stored BIN prefix\n"
               << "  --format <type>       Output format: pretty, json, csv (default: pretty)\n"
               << "  --color               Enable colored output (default)\n"
               << "  --no-color            Disable colored output\n"
@@ -43,6 +60,22 @@ OutputFormat parse_format(const std::string& s) {
     return OutputFormat::Pretty;
 }
 
+LibBIN::IndexKind parse_index(const std::string& s) {
+    if (s == "hash") return LibBIN::IndexKind::Hash;
+    if (s == "sorted") return LibBIN::IndexKind::Sorted;
+    if (s == "direct") return LibBIN::IndexKind::Direct;
+    if (s == "prefix") return LibBIN::IndexKind::Prefix;
+    if (s == "perfect") return LibBIN::IndexKind::Perfect;
+    if (s == "tree") return LibBIN::IndexKind::Tree;
+    return LibBIN::IndexKind::Auto;
+}
+
+LibBIN::HugePages parse_huge_pages(const std::string& s) {
+    if (s == "transparent") return LibBIN::HugePages::Transparent;
+    if (s == "explicit") return LibBIN::HugePages::Explicit;
+    return LibBIN::HugePages::Off;
+}
+
 void format_output(const LibBIN::Result& result, const CLIOptions& opts) {
     std::ostream& out = *(opts.out_stream);
 
@@ -75,7 +108,7 @@ int run_cli_mode(const CLIOptions& opts) {
         if (!std::getline(std::cin, input) || input == "exit")
             break;
 
-        auto result = LibBIN::Lookup::Search(input);
+        auto result = LibBIN::Lookup::Search(input, opts.match);
         if (result) {
             format_output(*result, opts);
         } else {
@@ -94,7 +127,7 @@ int run_batch_mode(CLIOptions& opts) {
 
     std::string line;
     while (std::getline(infile, line)) {
-        auto result = LibBIN::Lookup::Search(line);
+        auto result = LibBIN::Lookup::Search(line, opts.match);
         if (result) {
             if (!opts.quiet || !opts.output_file.empty())
                 format_output(*result, opts);
@@ -114,10 +147,32 @@ int main(int argc, char* argv[]) {
 
         if (arg == "--bin" && i + 1 < argc) {
             opts.bin = argv[++i];
+        } else if (arg == "--pan" && i + 1 < argc) {
+            opts.pan = argv[++i];
         } else if (arg == "--file" && i + 1 < argc) {
             opts.file_input = argv[++i];
         } else if (arg == "--output" && i + 1 < argc) {
             opts.output_file = argv[++i];
+        } else if (arg == "--snapshot" && i + 1 < argc) {
+            opts.snapshot = argv[++i];
+        } else if (arg == "--index" && i + 1 < argc) {
+            opts.load.index = parse_index(argv[++i]);
+        } else if (arg == "--threads" && i + 1 < argc) {
+            opts.load.threads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--packed") {
+            opts.load.packed = true;
+        } else if (arg == "--huge-pages" && i + 1 < argc) {
+            opts.load.huge_pages = parse_huge_pages(argv[++i]);
+        } else if (arg == "--prefault") {
+            opts.load.prefault = true;
+        } else if (arg == "--mlock") {
+            opts.load.lock_memory = true;
+        } else if (arg == "--no-negative-filter") {
+            opts.load.negative_filter = false;
+        } else if (arg == "--delta" && i + 1 < argc) {
+            opts.delta = argv[++i];
+        } else if (arg == "--longest") {
+            opts.match = LibBIN::MatchMode::LongestPrefix;
         } else if (arg == "--format" && i + 1 < argc) {
             opts.format = parse_format(argv[++i]);
         } else if (arg == "--no-color") {
@@ -145,10 +200,22 @@ int main(int argc, char* argv[]) {
         opts.out_stream = &opts.owned_ofstream;
     }
 
-    LibBIN::Lookup::load_bins();
+    if (!opts.snapshot.empty()) {
+        LibBIN::Lookup::load_snapshot(opts.snapshot, opts.load);
+    } else {
+        LibBIN::Lookup::load_bins("/usr/share/LibBIN/bin_data.csv", opts.load);
+    }
+
+    if (!opts.delta.empty()) {
+        if (auto applied = LibBIN::Lookup::apply_delta(opts.delta); !applied) {
+            std::cerr << "Error: " << applied.error().what() << "\n";
+            return 1;
+        }
+    }
 
-    if (!opts.bin.empty()) {
-        auto result = LibBIN::Lookup::Search(opts.bin);
+    if (!opts.bin.empty() || !opts.pan.empty()) {
+        auto result = opts.pan.empty() ? LibBIN::Lookup::Search(opts.bin, opts.match)
+                                       : LibBIN::Lookup::SearchPan(opts.pan);
         if (result) {
             if (!opts.quiet || !opts.output_file.empty())
                 format_output(*result, opts);
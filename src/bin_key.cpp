@@ -0,0 +1,144 @@
+#include "bin_key.hpp"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define LIBBIN_X86 1
+#endif
+
+namespace LibBIN {
+
+static auto parse_bins_scalar(std::span<const std::string_view> bins, std::span<std::optional<BinKey>> out) noexcept {
+    for (std::size_t i = 0; i < bins.size(); ++i) out[i] = BinKey::parse(bins[i]);
+}
+
+static constexpr auto valid_length(std::string_view bin) noexcept -> bool {
+    return bin.size() >= BinKey::min_digits && bin.size() <= BinKey::max_digits;
+}
+
+static constexpr auto pack(std::uint32_t padded, std::size_t digits) noexcept -> BinKey {
+    return BinKey{padded << 2 | static_cast<std::uint32_t>(digits - BinKey::min_digits)};
+}
+
+#ifdef LIBBIN_X86
+
+// Each BIN is loaded into an 8-byte lane with two overlapping 4-byte loads
+// and the bytes past its end set to '0', which pads it to eight digits
+// without a variable-length copy. Subtracting '0' leaves bytes <= 9 only
+// for digits; maddubs then folds digit pairs (x10 + x1) and madd folds
+// pairs of pairs (x100 + x1), leaving the two 4-digit halves as 32-bit
+// integers. Only call with valid_length(bin).
+static auto load_lane(std::string_view bin) noexcept -> std::uint64_t {
+    constexpr std::uint64_t padding[] = {0x3030ull << 48, 0x30ull << 56, 0};
+    std::uint32_t head;
+    std::uint32_t tail;
+    std::memcpy(&head, bin.data(), 4);
+    std::memcpy(&tail, bin.data() + bin.size() - 4, 4);
+    return head | std::uint64_t{tail} << (8 * (bin.size() - 4)) | padding[bin.size() - BinKey::min_digits];
+}
+
+__attribute__((target("ssse3")))
+static auto parse_bin_ssse3(std::string_view bin) noexcept -> std::optional<BinKey> {
+    if (!valid_length(bin)) return std::nullopt;
+    const __m128i lane = _mm_cvtsi64_si128(static_cast<long long>(load_lane(bin)));
+    const __m128i digits = _mm_sub_epi8(lane, _mm_set1_epi8('0'));
+    const __m128i nine = _mm_set1_epi8(9);
+    if ((_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(digits, nine), nine)) & 0xFF) != 0xFF) return std::nullopt;
+
+    const __m128i pairs = _mm_maddubs_epi16(digits, _mm_setr_epi8(10, 1, 10, 1, 10, 1, 10, 1, 0, 0, 0, 0, 0, 0, 0, 0));
+    const __m128i quads = _mm_madd_epi16(pairs, _mm_setr_epi16(100, 1, 100, 1, 0, 0, 0, 0));
+    const auto high = static_cast<std::uint32_t>(_mm_cvtsi128_si32(quads));
+    const auto low = static_cast<std::uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(quads, 4)));
+    return pack(high * 10000 + low, bin.size());
+}
+
+__attribute__((target("ssse3")))
+static void parse_bins_ssse3(std::span<const std::string_view> bins, std::span<std::optional<BinKey>> out) noexcept {
+    for (std::size_t i = 0; i < bins.size(); ++i) out[i] = parse_bin_ssse3(bins[i]);
+}
+
+__attribute__((target("avx2")))
+static void parse_bins_avx2(std::span<const std::string_view> bins, std::span<std::optional<BinKey>> out) noexcept {
+    const __m256i zero = _mm256_set1_epi8('0');
+    const __m256i nine = _mm256_set1_epi8(9);
+    const __m256i tens = _mm256_set1_epi16(0x010A);
+    const __m256i hundreds = _mm256_set1_epi32(0x00010064);
+    const __m256i ten_thousand = _mm256_set1_epi64x(10000);
+
+    std::size_t i = 0;
+    for (; i + 4 <= bins.size(); i += 4) {
+        std::uint64_t lanes[4];
+        for (std::size_t k = 0; k < 4; ++k) {
+            // An all-0xFF lane fails the digit check below.
+            lanes[k] = valid_length(bins[i + k]) ? load_lane(bins[i + k]) : ~std::uint64_t{0};
+        }
+
+        const __m256i packed = _mm256_set_epi64x(static_cast<long long>(lanes[3]), static_cast<long long>(lanes[2]),
+                                                 static_cast<long long>(lanes[1]), static_cast<long long>(lanes[0]));
+        const __m256i digits = _mm256_sub_epi8(packed, zero);
+        const auto ok = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_max_epu8(digits, nine), nine)));
+        const __m256i quads = _mm256_madd_epi16(_mm256_maddubs_epi16(digits, tens), hundreds);
+        const __m256i values = _mm256_add_epi64(_mm256_mul_epu32(quads, ten_thousand), _mm256_srli_epi64(quads, 32));
+
+        alignas(32) std::uint64_t padded[4];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(padded), values);
+        for (std::size_t k = 0; k < 4; ++k) {
+            if (((ok >> (8 * k)) & 0xFF) == 0xFF) {
+                out[i + k] = pack(static_cast<std::uint32_t>(padded[k]), bins[i + k].size());
+            } else {
+                out[i + k] = std::nullopt;
+            }
+        }
+    }
+    parse_bins_ssse3(bins.subspan(i), out.subspan(i));
+}
+
+#endif
+
+auto detected_simd_level() noexcept -> SimdLevel {
+#ifdef LIBBIN_X86
+    static const SimdLevel level = [] {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) return SimdLevel::AVX2;
+        if (__builtin_cpu_supports("ssse3")) return SimdLevel::SSSE3;
+        return SimdLevel::Scalar;
+    }();
+    return level;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+auto parse_bin(std::string_view bin) noexcept -> std::optional<BinKey> {
+    return parse_bin(bin, detected_simd_level());
+}
+
+auto parse_bin(std::string_view bin, SimdLevel level) noexcept -> std::optional<BinKey> {
+#ifdef LIBBIN_X86
+    if (std::min(level, detected_simd_level()) != SimdLevel::Scalar) return parse_bin_ssse3(bin);
+#endif
+    (void)level;
+    return BinKey::parse(bin);
+}
+
+void parse_bins(std::span<const std::string_view> bins, std::span<std::optional<BinKey>> out) noexcept {
+    parse_bins(bins, out, detected_simd_level());
+}
+
+void parse_bins(std::span<const std::string_view> bins, std::span<std::optional<BinKey>> out,
+                SimdLevel level) noexcept {
+    const std::size_t count = std::min(bins.size(), out.size());
+    bins = bins.first(count);
+    out = out.first(count);
+#ifdef LIBBIN_X86
+    switch (std::min(level, detected_simd_level())) {
+        case SimdLevel::AVX2: return parse_bins_avx2(bins, out);
+        case SimdLevel::SSSE3: return parse_bins_ssse3(bins, out);
+        case SimdLevel::Scalar: break;
+    }
+#endif
+    (void)level;
+    parse_bins_scalar(bins, out);
+}
+}
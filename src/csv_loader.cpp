@@ -0,0 +1,291 @@
+#include "csv_loader.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <format>
+#include <thread>
+#include <vector>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace LibBIN {
+
+// Bitmasks over one 64-byte block: bit i is set if byte i matches.
+struct CsvMasks {
+    std::uint64_t quotes = 0;
+    std::uint64_t commas = 0;
+    std::uint64_t newlines = 0;
+};
+
+static auto scan_block(const char* block) noexcept -> CsvMasks {
+    CsvMasks masks;
+#ifdef __SSE2__
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i newline = _mm_set1_epi8('\n');
+    for (int i = 0; i < 4; ++i) {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16 * i));
+        auto bits = [&](__m128i c) {
+            return std::uint64_t{static_cast<std::uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, c)))} << (16 * i);
+        };
+        masks.quotes |= bits(quote);
+        masks.commas |= bits(comma);
+        masks.newlines |= bits(newline);
+    }
+#else
+    for (int i = 0; i < 64; ++i) {
+        masks.quotes |= std::uint64_t{block[i] == '"'} << i;
+        masks.commas |= std::uint64_t{block[i] == ','} << i;
+        masks.newlines |= std::uint64_t{block[i] == '\n'} << i;
+    }
+#endif
+    return masks;
+}
+
+// Masks for the 64 bytes at `offset`, zero-padding a short final block.
+static auto scan_at(std::string_view text, std::size_t offset) noexcept -> CsvMasks {
+    if (text.size() - offset >= 64) return scan_block(text.data() + offset);
+    char tail[64] = {};
+    std::memcpy(tail, text.data() + offset, text.size() - offset);
+    return scan_block(tail);
+}
+
+// Bit i of the result is the XOR of bits 0..i: set when bytes 0..i hold an
+// odd number of quotes. That marks a quoted field's opening quote and its
+// contents as inside, and its closing quote as outside. Quotes are never
+// commas or newlines, so only the contents matter for masking structurals.
+static constexpr auto prefix_xor(std::uint64_t x) noexcept -> std::uint64_t {
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+}
+
+// Strips the quotes around a quoted field and collapses "" to ", using
+// `storage` only when the field contains escaped quotes. `escaped` is false
+// when the scanner has proven the field holds no adjacent quotes.
+static auto unquote(std::string_view field, bool escaped, std::string& storage) -> std::string_view {
+    if (field.empty() || field.front() != '"') return field;
+    field.remove_prefix(1);
+    if (!field.empty() && field.back() == '"') field.remove_suffix(1);
+    if (!escaped || field.find('"') == std::string_view::npos) return field;
+    storage.clear();
+    for (std::size_t i = 0; i < field.size(); ++i) {
+        storage += field[i];
+        if (field[i] == '"' && i + 1 < field.size() && field[i + 1] == '"') ++i;
+    }
+    return storage;
+}
+
+auto CsvReader::open(const std::string& path) -> std::expected<CsvReader, LookupError> {
+    auto file = MappedFile::open(path);
+    if (!file) {
+        return std::unexpected{LookupError(std::format("Failed to open BIN CSV file: {}", path))};
+    }
+    CsvReader reader({reinterpret_cast<const char*>(file->data()), file->size()});
+    reader.file_ = std::move(*file);
+    return reader;
+}
+
+auto CsvReader::next_structural() noexcept -> std::size_t {
+    while (structurals_ == 0) {
+        if (block_ >= text_.size()) return std::string_view::npos;
+        CsvMasks masks = scan_at(text_, block_);
+        if (std::uint64_t pairs = masks.quotes & (masks.quotes << 1 | last_quote_)) {
+            last_pair_ = block_ + 63 - static_cast<std::size_t>(std::countl_zero(pairs));
+        }
+        last_quote_ = masks.quotes >> 63;
+        std::uint64_t inside = prefix_xor(masks.quotes) ^ in_quotes_;
+        in_quotes_ = static_cast<std::uint64_t>(static_cast<std::int64_t>(inside) >> 63);
+        structurals_ = (masks.commas | masks.newlines) & ~inside;
+        block_base_ = block_;
+        block_ += 64;
+    }
+    std::size_t offset = block_base_ + static_cast<std::size_t>(std::countr_zero(structurals_));
+    structurals_ &= structurals_ - 1;
+    return offset;
+}
+
+auto CsvReader::next(CsvRow& row) -> bool {
+    if (pos_ >= text_.size()) return false;
+    row.size = 0;
+    const std::size_t line = pos_;
+    for (std::size_t field = pos_;;) {
+        std::size_t end = next_structural();
+        const bool last = end == std::string_view::npos || text_[end] == '\n';
+        pos_ = end == std::string_view::npos ? text_.size() : end + 1;
+        if (end == std::string_view::npos) end = text_.size();
+        std::size_t field_end = end;
+        if (last && field_end > field && text_[field_end - 1] == '\r') --field_end;
+        // An empty line has no fields.
+        if (last && row.size == 0 && field_end == line) return true;
+
+        if (row.size < CsvRow::max_fields) {
+            // The scanner runs ahead, so a pair past the field only costs a search.
+            const bool escaped = last_pair_ != std::string_view::npos && last_pair_ > field;
+            row.fields[row.size] = unquote({text_.data() + field, field_end - field}, escaped, row.unescaped[row.size]);
+        }
+        ++row.size;
+        if (last) return true;
+        field = end + 1;
+    }
+}
+
+// Columns of a bin_data.csv row.
+static constexpr std::size_t bin_csv_fields = 7;
+
+// Maps the bin_data.csv columns starting at `first` onto record fields;
+// false for short rows.
+static auto to_record(const CsvRow& line, std::size_t first, RecordFields& r) noexcept -> bool {
+    if (line.size < first + bin_csv_fields) return false;
+    const auto* f = line.fields.data() + first;
+    r = RecordFields{};
+    r.bin = f[0];
+    r.country = f[1];
+    r.scheme = f[3];
+    r.type = f[4];
+    r.brand = f[5];
+    r.bank = f[6];
+    r.is_valid = !r.bin.empty() && !r.country.empty();
+    return true;
+}
+
+auto read_bin_csv(const std::string& csv_path, const std::function<void(const RecordFields&)>& row)
+    -> std::expected<CsvStats, LookupError> {
+    auto reader = CsvReader::open(csv_path);
+    if (!reader) {
+        return std::unexpected{reader.error()};
+    }
+
+    CsvRow line;
+    reader->next(line);
+    CsvStats stats;
+    RecordFields r;
+    while (reader->next(line)) {
+        ++stats.rows;
+        if (!to_record(line, 0, r)) {
+            ++stats.skipped_rows;
+            continue;
+        }
+        row(r);
+    }
+    return stats;
+}
+
+auto read_bin_delta(const std::string& delta_path, const std::function<void(DeltaOp, const RecordFields&)>& row)
+    -> std::expected<CsvStats, LookupError> {
+    auto reader = CsvReader::open(delta_path);
+    if (!reader) {
+        return std::unexpected{reader.error()};
+    }
+
+    CsvRow line;
+    reader->next(line);
+    CsvStats stats;
+    RecordFields r;
+    while (reader->next(line)) {
+        ++stats.rows;
+        if (line.size >= 2 && line.fields[0] == "D") {
+            r = RecordFields{};
+            r.bin = line.fields[1];
+            row(DeltaOp::Delete, r);
+        } else if (line.size > 0 && line.fields[0] == "U" && to_record(line, 1, r)) {
+            row(DeltaOp::Upsert, r);
+        } else {
+            ++stats.skipped_rows;
+        }
+    }
+    return stats;
+}
+
+// Runs `task(i)` for each i in `items` on its own thread.
+template <typename Task>
+static void run(const std::vector<std::size_t>& items, Task&& task) {
+    std::vector<std::jthread> workers;
+    workers.reserve(items.size());
+    for (std::size_t i : items) workers.emplace_back([&task, i] { task(i); });
+}
+
+static auto count_quotes(std::string_view text) noexcept -> std::size_t {
+    std::size_t count = 0;
+    std::size_t i = 0;
+    for (; i + 64 <= text.size(); i += 64) count += static_cast<std::size_t>(std::popcount(scan_block(text.data() + i).quotes));
+    return count + static_cast<std::size_t>(std::count(text.begin() + static_cast<std::ptrdiff_t>(i), text.end(), '"'));
+}
+
+// Offset just past the first newline at or after `from` that is outside
+// quotes, given whether `from` is inside a quoted field; text.size() if none.
+static auto record_end(std::string_view text, std::size_t from, bool quoted) noexcept -> std::size_t {
+    for (std::size_t i = from; i < text.size(); ++i) {
+        if (text[i] == '"') quoted = !quoted;
+        else if (text[i] == '\n' && !quoted) return i + 1;
+    }
+    return text.size();
+}
+
+auto read_bin_csv_parallel(const std::string& csv_path, unsigned threads)
+    -> std::expected<CsvSnapshot, LookupError> {
+    auto file = MappedFile::open(csv_path);
+    if (!file) {
+        return std::unexpected{LookupError(std::format("Failed to open BIN CSV file: {}", csv_path))};
+    }
+    std::string_view text(reinterpret_cast<const char*>(file->data()), file->size());
+    text.remove_prefix(record_end(text, 0, false));
+
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    // Cut at evenly spaced offsets, then move each cut to the end of the
+    // record it falls in. Whether a cut lies inside quotes follows from the
+    // parity of the quotes before it, counted per span in parallel.
+    std::vector<std::size_t> cuts(threads + 1, text.size());
+    cuts[0] = 0;
+    for (unsigned k = 1; k < threads; ++k) cuts[k] = k * text.size() / threads;
+    std::vector<std::size_t> quotes(threads);
+    std::vector<std::size_t> spans(threads);
+    for (unsigned k = 0; k < threads; ++k) spans[k] = k;
+    run(spans, [&](std::size_t k) { quotes[k] = count_quotes(text.substr(cuts[k], cuts[k + 1] - cuts[k])); });
+    std::size_t seen = 0;
+    for (unsigned k = 1; k < threads; ++k) {
+        seen += quotes[k - 1];
+        cuts[k] = std::max(cuts[k - 1], record_end(text, cuts[k], seen % 2 == 1));
+    }
+    std::vector<std::string_view> chunks;
+    for (unsigned k = 0; k < threads; ++k) {
+        if (cuts[k + 1] > cuts[k]) chunks.push_back(text.substr(cuts[k], cuts[k + 1] - cuts[k]));
+    }
+
+    std::vector<CsvSnapshot> parts(chunks.size());
+    auto parse = [&](std::size_t i) {
+        CsvReader reader(chunks[i]);
+        CsvRow line;
+        RecordFields r;
+        while (reader.next(line)) {
+            ++parts[i].stats.rows;
+            if (!to_record(line, 0, r)) {
+                ++parts[i].stats.skipped_rows;
+                continue;
+            }
+            parts[i].writer.add(r);
+        }
+        parts[i].writer.sort();
+    };
+    std::vector<std::size_t> all(parts.size());
+    for (std::size_t i = 0; i < all.size(); ++i) all[i] = i;
+    run(all, parse);
+    for (std::size_t step = 1; step < parts.size(); step *= 2) {
+        std::vector<std::size_t> pairs;
+        for (std::size_t i = 0; i + step < parts.size(); i += 2 * step) pairs.push_back(i);
+        run(pairs, [&](std::size_t i) {
+            parts[i].writer.merge(std::move(parts[i + step].writer));
+            parts[i].stats.rows += parts[i + step].stats.rows;
+            parts[i].stats.skipped_rows += parts[i + step].stats.skipped_rows;
+        });
+    }
+    if (parts.empty()) return CsvSnapshot{};
+    return std::move(parts.front());
+}
+}
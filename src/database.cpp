@@ -0,0 +1,886 @@
+#include "database.hpp"
+#include "csv_loader.hpp"
+#include "direct_index.hpp"
+#include "flat_hash_index.hpp"
+#include "index_backend.hpp"
+#include "negative_filter.hpp"
+#include "numa.hpp"
+#include "pan.hpp"
+#include "perfect_hash.hpp"
+#include "prefix_index.hpp"
+#include "range_index.hpp"
+#include "residency.hpp"
+#include "search_tree.hpp"
+#include "snapshot.hpp"
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace LibBIN {
+
+// A snapshot plus the index built over it. Never modified once published;
+// a load or compaction builds a fresh one.
+struct Database::Base {
+    Snapshot snapshot;
+    IndexKind index_kind = IndexKind::Sorted;
+    FlatHashIndex hash_index;
+    DirectIndex direct_index;
+    PrefixIndex prefix_index;
+    RangeIndex range_index;
+    SearchTree search_tree;
+    // Checked before the index; empty if LoadOptions::negative_filter is off.
+    NegativeFilter filter;
+    // The snapshot's stored perfect hash, or `built_hash` if it has none or
+    // is packed (which releases the stored one). A packed layout also
+    // releases the key table the hash verifies against, so `hash_keys`
+    // then keeps a copy of it.
+    std::vector<std::uint32_t> hash_keys;
+    PerfectHash built_hash;
+    const PerfectHash* perfect_hash = nullptr;
+    bool locked = false;
+
+    // Indexes are built from the raw key table before a packed layout
+    // releases it.
+    Base(Snapshot image, IndexKind kind, const LoadOptions& options) : snapshot(std::move(image)), index_kind(kind) {
+        const bool packed = options.packed;
+        range_index = RangeIndex(snapshot.ranges(), static_cast<std::uint32_t>(snapshot.key_count()));
+        auto keys = snapshot.keys();
+        if (options.negative_filter) filter = NegativeFilter(keys, snapshot.ranges());
+        switch (kind) {
+            case IndexKind::Hash:
+                hash_index = *build_index<FlatHashIndex>(keys);
+                break;
+            case IndexKind::Direct:
+                direct_index = *build_index<DirectIndex>(keys);
+                break;
+            case IndexKind::Prefix:
+                prefix_index = *build_index<PrefixIndex>(keys);
+                break;
+            case IndexKind::Perfect:
+                if (!packed && !snapshot.perfect_hash().empty()) {
+                    perfect_hash = &snapshot.perfect_hash();
+                    break;
+                }
+                if (packed) hash_keys.assign(keys.begin(), keys.end());
+                if (auto hash = build_index<PerfectHash>(packed ? std::span<const std::uint32_t>(hash_keys) : keys)) {
+                    built_hash = std::move(*hash);
+                    perfect_hash = &built_hash;
+                } else {
+                    index_kind = IndexKind::Sorted;
+                }
+                break;
+            case IndexKind::Tree:
+                search_tree = *build_index<SearchTree>(keys);
+                break;
+            case IndexKind::Auto:
+            case IndexKind::Sorted:
+                break;
+        }
+        if (packed) snapshot.pack();
+    }
+
+    // Calls `f` with the backend index_kind selects, or with the snapshot
+    // itself for Sorted.
+    template <class F>
+    auto visit_index(F&& f) const -> decltype(auto) {
+        switch (index_kind) {
+            case IndexKind::Hash:
+                return f(hash_index);
+            case IndexKind::Direct:
+                return f(direct_index);
+            case IndexKind::Prefix:
+                return f(prefix_index);
+            case IndexKind::Perfect:
+                return f(*perfect_hash);
+            case IndexKind::Tree:
+                return f(search_tree);
+            case IndexKind::Auto:
+            case IndexKind::Sorted:
+                break;
+        }
+        return f(snapshot);
+    }
+
+    auto find_record(BinKey key) const noexcept -> std::optional<std::uint32_t> {
+        return visit_index([&]<class Index>(const Index& index) -> std::optional<std::uint32_t> {
+            if constexpr (IndexBackend<Index>) {
+                std::uint32_t id = index.find(key);
+                if (id == Index::npos) return std::nullopt;
+                return id;
+            } else {
+                return index.find(key);
+            }
+        });
+    }
+
+    auto find_longest_record(BinKey key) const noexcept -> std::optional<std::uint32_t> {
+        return visit_index([&]<class Index>(const Index& index) -> std::optional<std::uint32_t> {
+            if constexpr (LongestPrefixIndexBackend<Index>) {
+                std::uint32_t id = index.find_longest(key);
+                if (id == Index::npos) return std::nullopt;
+                return id;
+            } else {
+                for (std::size_t digits = key.digits(); digits >= BinKey::min_digits; --digits) {
+                    if (auto id = find_record(key.prefix(digits))) return id;
+                }
+                return std::nullopt;
+            }
+        });
+    }
+
+    // Record id of the first key not less than `key`, for ordered scans.
+    auto lower_bound(BinKey key) const noexcept -> std::size_t {
+        return visit_index([&]<class Index>(const Index& index) -> std::size_t {
+            if constexpr (OrderedIndexBackend<Index>) {
+                return index.lower_bound(key);
+            } else {
+                return snapshot.lower_bound(key);
+            }
+        });
+    }
+
+    // Record id of the range with exactly these bounds.
+    auto find_range(BinRange range) const noexcept -> std::optional<std::uint32_t> {
+        auto ranges = snapshot.ranges();
+        auto it = std::lower_bound(ranges.begin(), ranges.end(), range.first,
+                                   [](const SnapshotRange& r, std::uint32_t first) { return r.first < first; });
+        if (it == ranges.end() || it->first != range.first || it->last != range.last) return std::nullopt;
+        return static_cast<std::uint32_t>(snapshot.key_count() + static_cast<std::size_t>(it - ranges.begin()));
+    }
+
+    // False if the filter rules out every record `resolve(key, mode)` could find.
+    auto may_match(BinKey key, MatchMode mode) const noexcept -> bool {
+        return mode == MatchMode::LongestPrefix ? filter.may_contain_prefix(key) : filter.may_contain(key);
+    }
+
+    auto resolve(BinKey key, MatchMode mode) const noexcept -> std::optional<std::uint32_t> {
+        if (!may_match(key, mode)) return std::nullopt;
+        auto index = mode == MatchMode::LongestPrefix ? find_longest_record(key) : find_record(key);
+        if (!index && !range_index.empty()) {
+            if (std::uint32_t id = range_index.find(key); id != RangeIndex::npos) index = id;
+        }
+        return index;
+    }
+
+    // The sorted index exposes no single slot worth prefetching.
+    void prefetch_record(BinKey key) const noexcept {
+        visit_index([&]<class Index>(const Index& index) {
+            if constexpr (IndexBackend<Index>) index.prefetch(key);
+        });
+    }
+
+    ~Base() {
+        if (locked) unlock_memory(regions());
+    }
+
+    auto regions() const -> std::vector<MemoryRegion> {
+        std::vector<MemoryRegion> out;
+        snapshot.memory_regions(out);
+        hash_index.memory_regions(out);
+        direct_index.memory_regions(out);
+        prefix_index.memory_regions(out);
+        range_index.memory_regions(out);
+        search_tree.memory_regions(out);
+        built_hash.memory_regions(out);
+        out.push_back(memory_region(hash_keys));
+        filter.memory_regions(out);
+        return out;
+    }
+
+    // Applies the residency options; called before the base is shared.
+    auto make_resident(const LoadOptions& options) -> std::expected<void, LookupError> {
+        if (options.huge_pages == HugePages::Explicit) {
+            if (auto moved = snapshot.move_to_huge_pages(); !moved) {
+                return std::unexpected{moved.error()};
+            }
+        }
+        auto blocks = regions();
+        if (options.huge_pages != HugePages::Off) advise_huge_pages(blocks);
+        if (options.prefault) prefault(blocks);
+        if (options.lock_memory) {
+            if (auto pinned = lock_memory(blocks); !pinned) {
+                return std::unexpected{pinned.error()};
+            }
+            locked = true;
+        }
+        return {};
+    }
+
+    auto memory_usage() const noexcept -> std::size_t {
+        return snapshot.memory_usage() + hash_index.memory_usage() + direct_index.memory_usage()
+             + prefix_index.memory_usage() + range_index.memory_usage() + search_tree.memory_usage()
+             + built_hash.memory_usage() + hash_keys.capacity() * sizeof(std::uint32_t) + filter.memory_usage();
+    }
+};
+
+// Changes applied by deltas since the base was built: upserted records in a
+// snapshot searched before the base, and the sorted ids of deleted base
+// records.
+struct Database::Overlay {
+    Snapshot snapshot;
+    RangeIndex range_index;
+    std::vector<std::uint32_t> removed;
+
+    Overlay(Snapshot image, std::vector<std::uint32_t> removed_ids)
+        : snapshot(std::move(image)), removed(std::move(removed_ids)) {
+        range_index = RangeIndex(snapshot.ranges(), static_cast<std::uint32_t>(snapshot.key_count()));
+    }
+
+    auto removes(std::uint32_t base_id) const noexcept -> bool {
+        return !removed.empty() && std::binary_search(removed.begin(), removed.end(), base_id);
+    }
+
+    auto size() const noexcept -> std::size_t { return snapshot.size() + removed.size(); }
+
+    auto memory_usage() const noexcept -> std::size_t {
+        return snapshot.memory_usage() + range_index.memory_usage() + removed.capacity() * sizeof(std::uint32_t);
+    }
+};
+
+// What readers see: a base shared with later states until the next load or
+// compaction, and the overlay of deltas applied since, if any.
+struct Database::State {
+    std::shared_ptr<const Base> base;
+    std::shared_ptr<const Overlay> overlay;
+    // Live records once the overlay's shadowing and deletions are applied.
+    std::size_t size = 0;
+    // With LoadOptions::numa_replicas on a multi-node host, the copy of the
+    // base to use on each node id; `base` is one of them. Replicas hold
+    // identical data, so record ids and the overlay apply to all of them.
+    std::vector<std::shared_ptr<const Base>> replicas;
+
+    // A state with no overlay over `image`, its indexes and any replicas
+    // built and made resident per `options`.
+    static auto make(Snapshot image, IndexKind kind, const LoadOptions& options)
+        -> std::expected<std::unique_ptr<State>, LookupError> {
+        auto make_base = [&](Snapshot data) -> std::expected<std::shared_ptr<const Base>, LookupError> {
+            auto base = std::make_shared<Base>(std::move(data), kind, options);
+            if (auto resident = base->make_resident(options); !resident) {
+                return std::unexpected{resident.error()};
+            }
+            return base;
+        };
+
+        const auto& nodes = NumaTopology::get().nodes;
+        if (!options.numa_replicas || nodes.size() < 2) {
+            auto base = make_base(std::move(image));
+            if (!base) {
+                return std::unexpected{base.error()};
+            }
+            std::size_t size = (*base)->snapshot.size();
+            return std::make_unique<State>(State{std::move(*base), nullptr, size, {}});
+        }
+
+        // Each replica is copied and indexed on a thread bound to its node,
+        // so first-touch allocation places its pages there.
+        std::vector<std::expected<std::shared_ptr<const Base>, LookupError>> built(nodes.size());
+        {
+            std::vector<std::jthread> workers;
+            for (std::size_t i = 0; i < nodes.size(); ++i) {
+                workers.emplace_back([&, i] {
+                    bind_thread_to_numa_node(nodes[i]);
+                    auto copy = image.copy();
+                    built[i] = copy ? make_base(std::move(*copy)) : std::unexpected{copy.error()};
+                });
+            }
+        }
+        auto state = std::make_unique<State>();
+        state->replicas.resize(nodes.back() + 1);
+        for (std::size_t i = 0; i < nodes.size(); ++i) {
+            if (!built[i]) {
+                return std::unexpected{built[i].error()};
+            }
+            state->replicas[nodes[i]] = std::move(*built[i]);
+        }
+        state->base = state->replicas[nodes.front()];
+        for (auto& replica : state->replicas) {
+            if (!replica) replica = state->base;
+        }
+        state->size = state->base->snapshot.size();
+        return state;
+    }
+
+    // The replica for the calling thread's node, or the only base.
+    auto local() const noexcept -> const Base& {
+        if (replicas.empty()) return *base;
+        unsigned node = current_numa_node();
+        return node < replicas.size() ? *replicas[node] : *base;
+    }
+
+    auto resolve(const Base& base, BinKey key, MatchMode mode) const noexcept -> std::optional<ResultView> {
+        if (!overlay) {
+            auto id = base.resolve(key, mode);
+            if (!id) return std::nullopt;
+            return ResultView(&base.snapshot, *id);
+        }
+
+        // Each candidate length is tried in the overlay, then in the base,
+        // so an upsert or deletion at one length does not hide another. The
+        // base's filter only covers the base; the overlay is always searched.
+        const bool in_base = base.may_match(key, mode);
+        std::size_t shortest = mode == MatchMode::LongestPrefix ? BinKey::min_digits : key.digits();
+        for (std::size_t digits = key.digits(); digits >= shortest; --digits) {
+            BinKey candidate = key.prefix(digits);
+            if (auto id = overlay->snapshot.find(candidate)) return ResultView(&overlay->snapshot, *id);
+            if (!in_base) continue;
+            if (auto id = base.find_record(candidate); id && !overlay->removes(*id)) {
+                return ResultView(&base.snapshot, *id);
+            }
+        }
+        if (std::uint32_t id = overlay->range_index.find(key); id != RangeIndex::npos) {
+            return ResultView(&overlay->snapshot, id);
+        }
+        if (!in_base) return std::nullopt;
+        if (std::uint32_t id = base.range_index.find(key); id != RangeIndex::npos && !overlay->removes(id)) {
+            return ResultView(&base.snapshot, id);
+        }
+        return std::nullopt;
+    }
+
+    auto memory_usage() const noexcept -> std::size_t {
+        std::size_t bytes = base->memory_usage() + (overlay ? overlay->memory_usage() : 0);
+        for (std::size_t node = 0; node < replicas.size(); ++node) {
+            // Nodes without their own replica alias `base`.
+            if (replicas[node] != base) bytes += replicas[node]->memory_usage();
+        }
+        return bytes;
+    }
+};
+
+static auto thread_stripe(unsigned stripes) noexcept -> unsigned {
+    static std::atomic<unsigned> next{0};
+    thread_local unsigned stripe = next.fetch_add(1, std::memory_order_relaxed);
+    return stripe % stripes;
+}
+
+// The count is taken under the epoch read after it was taken, so a load that
+// flips the epoch afterwards is sure to wait for this reader; if the epoch
+// moved in between, the count is retried under the new one.
+Database::ReadGuard::ReadGuard(const Database& database) noexcept
+    : database_(database), stripe_(thread_stripe(reader_stripes)) {
+    auto& readers = database_.stripes_[stripe_].readers;
+    for (unsigned epoch = database_.epoch_.load(std::memory_order_seq_cst);;) {
+        parity_ = epoch & 1;
+        readers[parity_].fetch_add(1, std::memory_order_seq_cst);
+        unsigned now = database_.epoch_.load(std::memory_order_seq_cst);
+        if (now == epoch) break;
+        readers[parity_].fetch_sub(1, std::memory_order_release);
+        epoch = now;
+    }
+}
+
+Database::ReadGuard::~ReadGuard() {
+    database_.stripes_[stripe_].readers[parity_].fetch_sub(1, std::memory_order_release);
+}
+
+Database::Database() = default;
+
+Database::~Database() {
+    if (compactor_.joinable()) compactor_.join();
+    delete current_.load(std::memory_order_acquire);
+}
+
+static auto to_result(const RecordFields& r) -> Result {
+    return Result{
+        std::string(r.bin), std::string(r.scheme), std::string(r.type), std::string(r.brand), std::string(r.bank),
+        std::string(r.country), std::string(r.country_code), std::string(r.level), std::string(r.country_flag),
+        r.prepaid, r.is_valid,
+    };
+}
+
+static auto fields_of(const Snapshot& snapshot, std::uint32_t id) noexcept -> RecordFields {
+    return RecordFields{
+        snapshot.bin(id),
+        snapshot.field(id, RecordField::Scheme),
+        snapshot.field(id, RecordField::Type),
+        snapshot.field(id, RecordField::Brand),
+        snapshot.field(id, RecordField::Bank),
+        snapshot.field(id, RecordField::Country),
+        snapshot.field(id, RecordField::CountryCode),
+        snapshot.field(id, RecordField::Level),
+        snapshot.field(id, RecordField::CountryFlag),
+        (snapshot.flags(id) & snapshot_prepaid) != 0,
+        (snapshot.flags(id) & snapshot_valid) != 0,
+    };
+}
+
+static auto build_snapshot(SnapshotWriter& writer) -> std::expected<Snapshot, LookupError> {
+    auto serialized = writer.serialize();
+    if (!serialized) {
+        return std::unexpected{LookupError("Failed to build BIN database: " + std::string(serialized.error().what()))};
+    }
+    auto image = Snapshot::from_image(std::move(*serialized));
+    if (!image) {
+        return std::unexpected{LookupError("Failed to build BIN database: " + std::string(image.error().what()))};
+    }
+    return std::move(*image);
+}
+
+static auto build(bool snapshot, const std::string& path, const LoadOptions& options)
+    -> std::expected<std::pair<Snapshot, IndexKind>, LookupError> {
+    if (snapshot) {
+        auto opened = Snapshot::open(path, options.prefault);
+        if (!opened) {
+            return std::unexpected{LookupError("Failed to load BIN snapshot: " + std::string(opened.error().what()))};
+        }
+        auto kind = options.index;
+        // Profiling reads every key, so an explicit choice skips it and
+        // leaves a mapped snapshot's pages untouched.
+        if (kind == IndexKind::Auto) {
+            auto data = DatasetProfile::of(opened->keys(), opened->ranges().size());
+            data.snapshot = true;
+            data.stored_perfect_hash = !opened->perfect_hash().empty();
+            kind = select_index(data, options);
+        }
+        return std::pair{std::move(*opened), kind};
+    }
+
+    SnapshotWriter writer;
+    if (options.threads == 1) {
+        auto csv = read_bin_csv(path, [&](const RecordFields& r) { writer.add(r); });
+        if (!csv) {
+            return std::unexpected{csv.error()};
+        }
+    } else {
+        auto csv = read_bin_csv_parallel(path, options.threads);
+        if (!csv) {
+            return std::unexpected{csv.error()};
+        }
+        writer = std::move(csv->writer);
+    }
+    auto image = build_snapshot(writer);
+    if (!image) {
+        return std::unexpected{image.error()};
+    }
+    auto kind = options.index;
+    if (kind == IndexKind::Auto) kind = select_index(DatasetProfile::of(image->keys(), image->ranges().size()), options);
+    return std::pair{std::move(*image), kind};
+}
+
+// Swaps in `next`, flips the epoch, then frees the previous state once the
+// readers counted under the old epoch are done. A reader holding the old
+// pointer confirmed the old epoch after counting itself and before the
+// flip, so it is among them; readers counted under the new epoch load the
+// pointer after the swap and only see `next`. The previous publish waited
+// out every earlier reader of this parity, so only readers that started
+// before the flip are waited for, however busy the database is. Caller
+// holds load_mutex_.
+void Database::publish(const State* next) {
+    std::unique_ptr<const State> previous(current_.exchange(next, std::memory_order_seq_cst));
+    if (!previous) return;
+    const unsigned parity = epoch_.fetch_add(1, std::memory_order_seq_cst) & 1;
+    for (auto& stripe : stripes_) {
+        while (stripe.readers[parity].load(std::memory_order_seq_cst) != 0) std::this_thread::yield();
+    }
+}
+
+auto Database::load(Source source) -> std::expected<void, LookupError> {
+    auto built = build(source.snapshot, source.path, source.options);
+    if (!built) {
+        return std::unexpected{built.error()};
+    }
+    auto state = State::make(std::move(built->first), built->second, source.options);
+    if (!state) {
+        return std::unexpected{state.error()};
+    }
+    std::lock_guard<std::mutex> lock(load_mutex_);
+    source_ = std::move(source);
+    publish(state->release());
+    return {};
+}
+
+auto Database::load_bins(const std::string& csv_path, const LoadOptions& options) -> std::expected<void, LookupError> {
+    return load({false, csv_path, options});
+}
+
+auto Database::load_snapshot(const std::string& snapshot_path, const LoadOptions& options)
+    -> std::expected<void, LookupError> {
+    return load({true, snapshot_path, options});
+}
+
+auto Database::reload() -> std::expected<void, LookupError> {
+    Source source;
+    {
+        std::lock_guard<std::mutex> lock(load_mutex_);
+        if (!current_.load(std::memory_order_acquire)) {
+            return std::unexpected{LookupError("BIN database not loaded")};
+        }
+        source = source_;
+    }
+    return load(std::move(source));
+}
+
+// The overlay is rebuilt from the previous one plus the delta's rows, so its
+// cost tracks the changes applied since the last compaction.
+auto Database::apply_delta(const std::string& delta_path) -> std::expected<DeltaStats, LookupError> {
+    std::lock_guard<std::mutex> lock(load_mutex_);
+    const State* state = current_.load(std::memory_order_acquire);
+    if (!state) {
+        return std::unexpected{LookupError("BIN database not loaded")};
+    }
+    const Base& base = *state->base;
+
+    std::map<BinKey, Result> points;
+    std::map<BinRange, Result> ranges;
+    std::vector<std::uint32_t> removed;
+    if (state->overlay) {
+        const Snapshot& upserts = state->overlay->snapshot;
+        auto keys = upserts.keys();
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            points.emplace(BinKey{keys[i]}, upserts.record(static_cast<std::uint32_t>(i)));
+        }
+        auto spans = upserts.ranges();
+        for (std::size_t i = 0; i < spans.size(); ++i) {
+            ranges.emplace(BinRange{spans[i].first, spans[i].last},
+                           upserts.record(static_cast<std::uint32_t>(keys.size() + i)));
+        }
+        removed = state->overlay->removed;
+    }
+
+    // Compaction writes base and overlay ranges together, and the writer
+    // keeps only the first of overlapping ranges. So an upserted range may
+    // replace a live range with the same bounds but must not overlap any
+    // other, or lookups would change when the overlay is compacted.
+    auto overlaps_live_range = [&](BinRange range) {
+        auto spans = base.snapshot.ranges();
+        auto it = std::lower_bound(spans.begin(), spans.end(), range.first,
+                                   [](const SnapshotRange& r, std::uint32_t first) { return r.last < first; });
+        for (; it != spans.end() && it->first <= range.last; ++it) {
+            if (it->first == range.first && it->last == range.last) continue;
+            auto id = static_cast<std::uint32_t>(base.snapshot.key_count() + static_cast<std::size_t>(it - spans.begin()));
+            if (std::find(removed.begin(), removed.end(), id) == removed.end()) return true;
+        }
+        for (auto it = ranges.begin(); it != ranges.end() && it->first.first <= range.last; ++it) {
+            if (it->first != range && it->first.last >= range.first) return true;
+        }
+        return false;
+    };
+
+    DeltaStats stats;
+    auto read = read_bin_delta(delta_path, [&](DeltaOp op, const RecordFields& r) {
+        if (auto key = parse_bin(r.bin)) {
+            if (op == DeltaOp::Upsert) {
+                points.insert_or_assign(*key, to_result(r));
+                ++stats.upserts;
+            } else {
+                points.erase(*key);
+                if (auto id = base.find_record(*key)) removed.push_back(*id);
+                ++stats.deletes;
+            }
+        } else if (auto range = BinRange::parse(r.bin)) {
+            if (op == DeltaOp::Upsert) {
+                if (overlaps_live_range(*range)) {
+                    ++stats.skipped_rows;
+                    return;
+                }
+                ranges.insert_or_assign(*range, to_result(r));
+                ++stats.upserts;
+            } else {
+                ranges.erase(*range);
+                if (auto id = base.find_range(*range)) removed.push_back(*id);
+                ++stats.deletes;
+            }
+        } else {
+            ++stats.skipped_rows;
+        }
+    });
+    if (!read) {
+        return std::unexpected{read.error()};
+    }
+    stats.skipped_rows += read->skipped_rows;
+
+    std::sort(removed.begin(), removed.end());
+    removed.erase(std::unique(removed.begin(), removed.end()), removed.end());
+
+    std::shared_ptr<const Overlay> overlay;
+    if (!points.empty() || !ranges.empty() || !removed.empty()) {
+        SnapshotWriter writer;
+        for (const auto& [key, record] : points) writer.add(record);
+        for (const auto& [range, record] : ranges) writer.add(record);
+        auto upserts = build_snapshot(writer);
+        if (!upserts) {
+            return std::unexpected{upserts.error()};
+        }
+        overlay = std::make_shared<const Overlay>(std::move(*upserts), std::move(removed));
+    }
+
+    // Upserts of live base records replace rather than add.
+    std::size_t size = base.snapshot.size();
+    if (overlay) {
+        size = size - overlay->removed.size() + overlay->snapshot.size();
+        for (const auto& [key, record] : points) {
+            if (auto id = base.find_record(key); id && !overlay->removes(*id)) --size;
+        }
+        for (const auto& [range, record] : ranges) {
+            if (auto id = base.find_range(range); id && !overlay->removes(*id)) --size;
+        }
+    }
+
+    std::size_t pending = overlay ? overlay->size() : 0;
+    publish(new State{state->base, std::move(overlay), size, state->replicas});
+
+    std::size_t threshold = source_.options.compaction_threshold;
+    if (threshold != 0 && pending >= threshold && !compacting_.exchange(true)) {
+        // The previous compactor has already left compact() once the flag
+        // is clear, so replacing it only joins a finished thread.
+        compactor_ = std::jthread([this] {
+            (void)compact();
+            compacting_.store(false);
+        });
+    }
+    return stats;
+}
+
+auto Database::compact() -> std::expected<void, LookupError> {
+    std::lock_guard<std::mutex> lock(load_mutex_);
+    const State* state = current_.load(std::memory_order_acquire);
+    if (!state || !state->overlay) return {};
+    const Snapshot& base = state->base->snapshot;
+    const Overlay& overlay = *state->overlay;
+
+    // Overlay records are added last so they win over the base records
+    // they shadow.
+    SnapshotWriter writer;
+    for (std::uint32_t id = 0; id < base.size(); ++id) {
+        if (!overlay.removes(id)) writer.add(fields_of(base, id));
+    }
+    for (std::uint32_t id = 0; id < overlay.snapshot.size(); ++id) {
+        writer.add(fields_of(overlay.snapshot, id));
+    }
+    auto image = build_snapshot(writer);
+    if (!image) {
+        return std::unexpected{image.error()};
+    }
+    auto rebuilt = State::make(std::move(*image), state->base->index_kind, source_.options);
+    if (!rebuilt) {
+        return std::unexpected{rebuilt.error()};
+    }
+    publish(rebuilt->release());
+    return {};
+}
+
+auto Database::loaded() const noexcept -> bool {
+    return current_.load(std::memory_order_acquire) != nullptr;
+}
+
+auto Database::size() const noexcept -> std::size_t {
+    ReadGuard guard(*this);
+    const State* state = current_.load(std::memory_order_seq_cst);
+    return state ? state->size : 0;
+}
+
+auto Database::overlay_size() const noexcept -> std::size_t {
+    ReadGuard guard(*this);
+    const State* state = current_.load(std::memory_order_seq_cst);
+    return state && state->overlay ? state->overlay->size() : 0;
+}
+
+auto Database::index_kind() const noexcept -> IndexKind {
+    ReadGuard guard(*this);
+    const State* state = current_.load(std::memory_order_seq_cst);
+    return state ? state->base->index_kind : IndexKind::Auto;
+}
+
+auto Database::memory_usage() const noexcept -> std::size_t {
+    ReadGuard guard(*this);
+    const State* state = current_.load(std::memory_order_seq_cst);
+    return state ? state->memory_usage() : 0;
+}
+
+auto Database::TrySearch(std::string_view bin, MatchMode mode) const noexcept -> std::expected<ResultView, SearchError> {
+    ReadGuard guard(*this);
+    const State* state = current_.load(std::memory_order_seq_cst);
+    if (!state) {
+        return std::unexpected{SearchError{ErrorCode::NotLoaded, bin}};
+    }
+    auto key = parse_bin(bin);
+    if (!key) {
+        return std::unexpected{SearchError{ErrorCode::InvalidFormat, bin}};
+    }
+    auto view = state->resolve(state->local(), *key, mode);
+    if (!view) {
+        return std::unexpected{SearchError{ErrorCode::NotFound, bin}};
+    }
+    return *view;
+}
+
+void Database::SearchBatch(std::span<const std::string_view> bins,
+                           std::span<std::expected<ResultView, SearchError>> out,
+                           MatchMode mode) const noexcept {
+    const std::size_t count = std::min(bins.size(), out.size());
+    ReadGuard guard(*this);
+    const State* state = current_.load(std::memory_order_seq_cst);
+    if (!state) {
+        for (std::size_t i = 0; i < count; ++i) {
+            out[i] = std::unexpected{SearchError{ErrorCode::NotLoaded, bins[i]}};
+        }
+        return;
+    }
+
+    // Keys are parsed a block at a time by the SIMD kernel and their index
+    // slots prefetched while the previous block is resolved.
+    const Base& base = state->local();
+    constexpr std::size_t block = 8;
+    std::array<std::optional<BinKey>, block> current_keys{};
+    std::array<std::optional<BinKey>, block> next_keys{};
+    auto stage = [&](std::size_t first, std::array<std::optional<BinKey>, block>& keys) {
+        std::size_t n = std::min(block, count - first);
+        parse_bins(bins.subspan(first, n), std::span(keys).first(n));
+        for (std::size_t k = 0; k < n; ++k) {
+            if (keys[k]) base.prefetch_record(*keys[k]);
+        }
+    };
+
+    if (count > 0) stage(0, current_keys);
+    for (std::size_t first = 0; first < count; first += block) {
+        if (first + block < count) stage(first + block, next_keys);
+        std::size_t n = std::min(block, count - first);
+        for (std::size_t k = 0; k < n; ++k) {
+            std::size_t j = first + k;
+            if (!current_keys[k]) {
+                out[j] = std::unexpected{SearchError{ErrorCode::InvalidFormat, bins[j]}};
+            } else if (auto view = state->resolve(base, *current_keys[k], mode)) {
+                view->prefetch();
+                out[j] = *view;
+            } else {
+                out[j] = std::unexpected{SearchError{ErrorCode::NotFound, bins[j]}};
+            }
+        }
+        std::swap(current_keys, next_keys);
+    }
+}
+
+auto Database::TrySearchPan(std::string_view pan) const noexcept -> std::expected<ResultView, SearchError> {
+    ReadGuard guard(*this);
+    const State* state = current_.load(std::memory_order_seq_cst);
+    if (!state) {
+        return std::unexpected{SearchError{ErrorCode::NotLoaded, pan_error_input(pan)}};
+    }
+    auto key = parse_pan(pan);
+    if (!key) {
+        return std::unexpected{SearchError{key.error(), pan_error_input(pan)}};
+    }
+    auto view = state->resolve(state->local(), *key, MatchMode::LongestPrefix);
+    if (!view) {
+        return std::unexpected{SearchError{ErrorCode::NotFound, pan_error_input(pan)}};
+    }
+    return *view;
+}
+
+void Database::SearchPanBatch(std::span<const std::string_view> pans,
+                              std::span<std::expected<ResultView, SearchError>> out) const noexcept {
+    const std::size_t count = std::min(pans.size(), out.size());
+    ReadGuard guard(*this);
+    const State* state = current_.load(std::memory_order_seq_cst);
+    if (!state) {
+        for (std::size_t i = 0; i < count; ++i) {
+            out[i] = std::unexpected{SearchError{ErrorCode::NotLoaded, pan_error_input(pans[i])}};
+        }
+        return;
+    }
+
+    // Same pipeline as SearchBatch, with a PAN parse in place of the BIN one.
+    const Base& base = state->local();
+    constexpr std::size_t block = 8;
+    using Keys = std::array<std::expected<BinKey, ErrorCode>, block>;
+    Keys current_keys{};
+    Keys next_keys{};
+    auto stage = [&](std::size_t first, Keys& keys) {
+        std::size_t n = std::min(block, count - first);
+        parse_pans(pans.subspan(first, n), std::span(keys).first(n));
+        for (std::size_t k = 0; k < n; ++k) {
+            if (keys[k]) base.prefetch_record(*keys[k]);
+        }
+    };
+
+    if (count > 0) stage(0, current_keys);
+    for (std::size_t first = 0; first < count; first += block) {
+        if (first + block < count) stage(first + block, next_keys);
+        std::size_t n = std::min(block, count - first);
+        for (std::size_t k = 0; k < n; ++k) {
+            std::size_t j = first + k;
+            if (!current_keys[k]) {
+                out[j] = std::unexpected{SearchError{current_keys[k].error(), pan_error_input(pans[j])}};
+            } else if (auto view = state->resolve(base, *current_keys[k], MatchMode::LongestPrefix)) {
+                view->prefetch();
+                out[j] = *view;
+            } else {
+                out[j] = std::unexpected{SearchError{ErrorCode::NotFound, pan_error_input(pans[j])}};
+            }
+        }
+        std::swap(current_keys, next_keys);
+    }
+}
+
+auto Database::SearchPan(std::string_view pan) const -> std::expected<Result, LookupError> {
+    ReadGuard guard(*this);
+    auto view = TrySearchPan(pan);
+    if (!view) {
+        return std::unexpected{view.error().to_error()};
+    }
+    return view->to_result();
+}
+
+auto Database::Scan(std::string_view first, std::string_view last,
+                    const std::function<void(const ResultView&)>& visit) const
+    -> std::expected<std::size_t, SearchError> {
+    ReadGuard guard(*this);
+    const State* state = current_.load(std::memory_order_seq_cst);
+    if (!state) {
+        return std::unexpected{SearchError{ErrorCode::NotLoaded, first}};
+    }
+    auto from = parse_bin(first);
+    if (!from) {
+        return std::unexpected{SearchError{ErrorCode::InvalidFormat, first}};
+    }
+    auto to = parse_bin(last);
+    if (!to) {
+        return std::unexpected{SearchError{ErrorCode::InvalidFormat, last}};
+    }
+
+    // Merges the base's keys with the overlay's; an overlay key shadows the
+    // same base key, and deleted base records are skipped.
+    const Base& base = state->local();
+    const Overlay* overlay = state->overlay.get();
+    std::size_t i = base.lower_bound(*from);
+    std::size_t j = overlay ? overlay->snapshot.lower_bound(*from) : 0;
+    std::size_t visited = 0;
+    while (true) {
+        bool in_base = i < base.snapshot.key_count() && base.snapshot.key(i) <= *to;
+        bool in_overlay = overlay && j < overlay->snapshot.key_count() && overlay->snapshot.key(j) <= *to;
+        if (!in_base && !in_overlay) break;
+        if (in_overlay && (!in_base || overlay->snapshot.key(j) <= base.snapshot.key(i))) {
+            if (in_base && overlay->snapshot.key(j) == base.snapshot.key(i)) ++i;
+            visit(ResultView(&overlay->snapshot, static_cast<std::uint32_t>(j++)));
+            ++visited;
+        } else {
+            auto id = static_cast<std::uint32_t>(i++);
+            if (overlay && overlay->removes(id)) continue;
+            visit(ResultView(&base.snapshot, id));
+            ++visited;
+        }
+    }
+    return visited;
+}
+
+auto Database::SearchView(std::string_view bin, MatchMode mode) const -> std::expected<ResultView, LookupError> {
+    auto view = TrySearch(bin, mode);
+    if (!view) {
+        return std::unexpected{view.error().to_error()};
+    }
+    return *view;
+}
+
+auto Database::Search(std::string_view bin, MatchMode mode) const -> std::expected<Result, LookupError> {
+    // Held across the copy so a concurrent load cannot free the record.
+    ReadGuard guard(*this);
+    auto view = TrySearch(bin, mode);
+    if (!view) {
+        return std::unexpected{view.error().to_error()};
+    }
+    return view->to_result();
+}
+}
@@ -0,0 +1,31 @@
+#include "direct_index.hpp"
+#include <algorithm>
+
+namespace LibBIN {
+
+DirectIndex::DirectIndex(std::span<const std::uint32_t> keys) : table_(slots, npos) {
+    for (std::size_t id = 0; id < keys.size(); ++id) {
+        BinKey key{keys[id]};
+        if (key.digits() == BinKey::min_digits) {
+            table_[key.padded() / 100] = static_cast<std::uint32_t>(id);
+        } else {
+            long_keys_.push_back(key.packed);
+            long_ids_.push_back(static_cast<std::uint32_t>(id));
+        }
+    }
+}
+
+auto DirectIndex::find_long(BinKey key) const noexcept -> std::uint32_t {
+    auto it = std::lower_bound(long_keys_.begin(), long_keys_.end(), key.packed);
+    if (it == long_keys_.end() || *it != key.packed) return npos;
+    return long_ids_[static_cast<std::size_t>(it - long_keys_.begin())];
+}
+
+auto DirectIndex::memory_usage() const noexcept -> std::size_t {
+    return (table_.capacity() + long_keys_.capacity() + long_ids_.capacity()) * sizeof(std::uint32_t);
+}
+
+void DirectIndex::memory_regions(std::vector<MemoryRegion>& out) const {
+    out.insert(out.end(), {memory_region(table_), memory_region(long_keys_), memory_region(long_ids_)});
+}
+}
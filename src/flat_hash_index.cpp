@@ -0,0 +1,38 @@
+#include "flat_hash_index.hpp"
+#include <bit>
+
+namespace LibBIN {
+
+FlatHashIndex::FlatHashIndex(std::span<const std::uint32_t> keys) : size_(keys.size()) {
+    if (keys.empty()) return;
+    // At most 7/8 full, so every probe sequence reaches an empty slot.
+    const std::size_t min_slots = keys.size() + keys.size() / 7 + 1;
+    const std::size_t groups = std::bit_ceil((min_slots + group_size - 1) / group_size);
+    group_mask_ = groups - 1;
+    ctrl_.assign(groups * group_size, empty);
+    slots_.assign(groups * group_size, Slot{npos, npos});
+
+    for (std::size_t id = 0; id < keys.size(); ++id) {
+        const std::uint64_t h = hash(keys[id]);
+        std::size_t group = (h >> 7) & group_mask_;
+        for (std::size_t step = 1;; ++step) {
+            const unsigned free = match_mask(ctrl_.data() + group * group_size, empty);
+            if (free != 0) {
+                const std::size_t slot = group * group_size + static_cast<std::size_t>(std::countr_zero(free));
+                ctrl_[slot] = static_cast<std::int8_t>(h & 0x7F);
+                slots_[slot] = {keys[id], static_cast<std::uint32_t>(id)};
+                break;
+            }
+            group = (group + step) & group_mask_;
+        }
+    }
+}
+
+auto FlatHashIndex::memory_usage() const noexcept -> std::size_t {
+    return ctrl_.capacity() + slots_.capacity() * sizeof(Slot);
+}
+
+void FlatHashIndex::memory_regions(std::vector<MemoryRegion>& out) const {
+    out.insert(out.end(), {memory_region(ctrl_), memory_region(slots_)});
+}
+}
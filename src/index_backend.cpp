@@ -0,0 +1,49 @@
+#include "index_backend.hpp"
+#include "direct_index.hpp"
+#include "flat_hash_index.hpp"
+#include "perfect_hash.hpp"
+#include "prefix_index.hpp"
+#include "search_tree.hpp"
+
+namespace LibBIN {
+
+static_assert(IndexBackend<FlatHashIndex>);
+static_assert(IndexBackend<DirectIndex>);
+static_assert(LongestPrefixIndexBackend<PrefixIndex>);
+static_assert(IndexBackend<PerfectHash>);
+static_assert(OrderedIndexBackend<SearchTree>);
+
+// Key tables at least this large outgrow the L2 cache, where binary search
+// falls well behind the tree.
+static constexpr std::size_t tree_min_keys = 65536;
+
+auto DatasetProfile::of(std::span<const std::uint32_t> keys, std::size_t ranges) noexcept -> DatasetProfile {
+    DatasetProfile profile{.keys = keys.size(), .ranges = ranges};
+    for (std::uint32_t key : keys) {
+        if (BinKey{key}.digits() == BinKey::min_digits) ++profile.six_digit_keys;
+    }
+    profile.long_keys = keys.size() - profile.six_digit_keys;
+    return profile;
+}
+
+auto select_index(const DatasetProfile& data, const LoadOptions& options) noexcept -> IndexKind {
+    if (options.index != IndexKind::Auto) return options.index;
+    // Any index built beside packed records would undo most of the saving.
+    if (options.packed) return IndexKind::Sorted;
+    // Once a quarter of the 6-digit space is used, the direct table costs
+    // at most 16 bytes per key, no more than the hash table, and answers
+    // with one load. Longer keys go to its binary-searched side table, so
+    // they have to be rare.
+    if (data.six_digit_keys * 4 >= DirectIndex::slots && data.long_keys * 8 <= data.keys) {
+        return IndexKind::Direct;
+    }
+    if (data.stored_perfect_hash) return IndexKind::Perfect;
+    // When ranges outnumber BINs most hits come from the range index, and
+    // the few point keys are not worth a separate table.
+    if (data.ranges > data.keys) return IndexKind::Sorted;
+    // Snapshots are served without a build step while binary search keeps
+    // up; CSV loads build the hash table anyway.
+    if (data.snapshot) return data.keys >= tree_min_keys ? IndexKind::Tree : IndexKind::Sorted;
+    return IndexKind::Hash;
+}
+}
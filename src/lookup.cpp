@@ -1,83 +1,81 @@
 #include "lookup.hpp"
-#include <fstream>
-#include <sstream>
 #include <iostream>
 #include <mutex>
-#include <unordered_map>
-#include <vector>
-#include <cctype>
 
 namespace LibBIN {
 
-static std::unordered_map<std::string, Result> bin_map;
-static bool bins_loaded = false;
 static std::mutex load_mutex;
 
-void Lookup::load_bins(const std::string& csv_path) {
-    std::lock_guard<std::mutex> lock(load_mutex);
-    if (bins_loaded) return;
+auto Lookup::database() noexcept -> Database& {
+    static Database instance;
+    return instance;
+}
 
-    std::ifstream file(csv_path);
-    if (!file.is_open()) {
-        std::cerr << "Failed to open BIN CSV file: " << csv_path << "\n";
-        return;
+void Lookup::load_bins(const std::string& csv_path, const LoadOptions& options) {
+    std::lock_guard<std::mutex> lock(load_mutex);
+    if (database().loaded()) return;
+    if (auto loaded = database().load_bins(csv_path, options); !loaded) {
+        std::cerr << loaded.error().what() << "\n";
     }
+}
 
-    std::string line;
-    std::getline(file, line);
-    auto trim_quotes = [](const std::string& s) -> std::string {
-        if (s.size() >= 2 && s.front() == '"' && s.back() == '"')
-            return s.substr(1, s.size() - 2);
-        return s;
-    };
-
-    bin_map.clear();
-    while (std::getline(file, line)) {
-        std::stringstream ss(line);
-        std::string token;
-        std::vector<std::string> fields;
-        while (std::getline(ss, token, ',')) {
-            fields.push_back(trim_quotes(token));
-        }
-        if (fields.size() < 7) continue;
-
-        Result r{};
-        r.bin = fields[0];
-        r.country = fields[1];
-        r.scheme = fields[3];
-        r.type = fields[4];
-        r.brand = fields[5];
-        r.bank = fields[6];
-        r.is_valid = !r.bin.empty() && !r.country.empty();
-
-        bin_map[r.bin] = std::move(r);
+void Lookup::load_snapshot(const std::string& snapshot_path, const LoadOptions& options) {
+    std::lock_guard<std::mutex> lock(load_mutex);
+    if (database().loaded()) return;
+    if (auto loaded = database().load_snapshot(snapshot_path, options); !loaded) {
+        std::cerr << loaded.error().what() << "\n";
     }
-    bins_loaded = true;
 }
 
-const std::unordered_map<std::string, Result>& Lookup::get_bin_map() {
-    return bin_map;
+auto Lookup::reload() -> std::expected<void, LookupError> {
+    return database().reload();
 }
 
-bool Lookup::is_valid_bin(std::string_view bin) {
-    if (bin.size() < 6 || bin.size() > 8) return false;
-    for (char c : bin) {
-        if (!std::isdigit(static_cast<unsigned char>(c))) return false;
-    }
-    return true;
+auto Lookup::apply_delta(const std::string& delta_path) -> std::expected<DeltaStats, LookupError> {
+    return database().apply_delta(delta_path);
 }
 
-auto Lookup::Search(std::string_view bin) -> std::expected<Result, LookupError> {
-    if (!bins_loaded) {
-        return std::unexpected{LookupError("BIN database not loaded. Call load_bins() first.")};
-    }
-    if (!is_valid_bin(bin)) {
-        return std::unexpected{InvalidFormatError{std::string(bin)}};
-    }
-    auto it = bin_map.find(std::string(bin));
-    if (it == bin_map.end()) {
-        return std::unexpected{NotFoundError{std::string(bin)}};
-    }
-    return it->second;
+auto Lookup::compact() -> std::expected<void, LookupError> {
+    return database().compact();
+}
+
+bool Lookup::is_valid_bin(std::string_view bin) noexcept {
+    return parse_bin(bin).has_value();
+}
+
+auto Lookup::TrySearch(std::string_view bin, MatchMode mode) noexcept -> std::expected<ResultView, SearchError> {
+    return database().TrySearch(bin, mode);
+}
+
+void Lookup::SearchBatch(std::span<const std::string_view> bins,
+                         std::span<std::expected<ResultView, SearchError>> out,
+                         MatchMode mode) noexcept {
+    database().SearchBatch(bins, out, mode);
+}
+
+auto Lookup::SearchView(std::string_view bin, MatchMode mode) -> std::expected<ResultView, LookupError> {
+    return database().SearchView(bin, mode);
+}
+
+auto Lookup::Search(std::string_view bin, MatchMode mode) -> std::expected<Result, LookupError> {
+    return database().Search(bin, mode);
+}
+
+auto Lookup::SearchPan(std::string_view pan) -> std::expected<Result, LookupError> {
+    return database().SearchPan(pan);
+}
+
+auto Lookup::TrySearchPan(std::string_view pan) noexcept -> std::expected<ResultView, SearchError> {
+    return database().TrySearchPan(pan);
+}
+
+void Lookup::SearchPanBatch(std::span<const std::string_view> pans,
+                            std::span<std::expected<ResultView, SearchError>> out) noexcept {
+    database().SearchPanBatch(pans, out);
+}
+
+auto Lookup::Scan(std::string_view first, std::string_view last,
+                  const std::function<void(const ResultView&)>& visit) -> std::expected<std::size_t, SearchError> {
+    return database().Scan(first, last, visit);
+}
 }
-} 
@@ -0,0 +1,90 @@
+#include "mapped_file.hpp"
+#include <cerrno>
+#include <cstring>
+#include <format>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace LibBIN {
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)),
+      length_(std::exchange(other.length_, 0)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        reset();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        length_ = std::exchange(other.length_, 0);
+    }
+    return *this;
+}
+
+MappedFile::~MappedFile() {
+    reset();
+}
+
+void MappedFile::reset() noexcept {
+    if (data_ != nullptr) {
+        ::munmap(const_cast<std::byte*>(data_), length_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+    length_ = 0;
+}
+
+auto MappedFile::open(const std::string& path, bool populate) -> std::expected<MappedFile, LookupError> {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return std::unexpected{LookupError(std::format("Failed to open {}: {}", path, std::strerror(errno)))};
+    }
+    struct stat st{};
+    if (::fstat(fd, &st) != 0) {
+        int err = errno;
+        ::close(fd);
+        return std::unexpected{LookupError(std::format("Failed to stat {}: {}", path, std::strerror(err)))};
+    }
+
+    MappedFile file;
+    if (st.st_size > 0) {
+        int flags = MAP_PRIVATE | (populate ? MAP_POPULATE : 0);
+        void* addr = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, flags, fd, 0);
+        if (addr == MAP_FAILED) {
+            int err = errno;
+            ::close(fd);
+            return std::unexpected{LookupError(std::format("Failed to map {}: {}", path, std::strerror(err)))};
+        }
+        file.data_ = static_cast<const std::byte*>(addr);
+        file.size_ = static_cast<std::size_t>(st.st_size);
+        file.length_ = file.size_;
+    }
+    ::close(fd);
+    return file;
+}
+
+auto MappedFile::copy(std::span<const std::byte> bytes, bool huge_pages) -> std::expected<MappedFile, LookupError> {
+    MappedFile file;
+    if (bytes.empty()) return file;
+
+    // munmap of a hugetlb mapping needs the length in whole huge pages.
+    constexpr std::size_t huge_page_size = std::size_t{2} << 20;
+    const std::size_t length = huge_pages ? (bytes.size() + huge_page_size - 1) & ~(huge_page_size - 1) : bytes.size();
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS | (huge_pages ? MAP_HUGETLB : 0);
+    void* addr = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, flags, -1, 0);
+    if (addr == MAP_FAILED) {
+        return std::unexpected{LookupError(std::format("Failed to map {} bytes{}: {}", length,
+                                                       huge_pages ? " of huge pages" : "", std::strerror(errno)))};
+    }
+    std::memcpy(addr, bytes.data(), bytes.size());
+    ::mprotect(addr, length, PROT_READ);
+    file.data_ = static_cast<const std::byte*>(addr);
+    file.size_ = bytes.size();
+    file.length_ = length;
+    return file;
+}
+}
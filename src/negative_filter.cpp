@@ -0,0 +1,44 @@
+#include "negative_filter.hpp"
+#include <algorithm>
+
+namespace LibBIN {
+
+// 16 bits per key in 512-bit blocks with eight bits set per key.
+static constexpr std::size_t keys_per_block = 32;
+
+static void set(std::vector<std::uint64_t>& bits, std::uint32_t prefix) noexcept {
+    bits[prefix / 64] |= std::uint64_t{1} << (prefix % 64);
+}
+
+NegativeFilter::NegativeFilter(std::span<const std::uint32_t> keys, std::span<const SnapshotRange> ranges)
+    : prefixes_((prefixes + 63) / 64, 0),
+      blocks_(std::max<std::size_t>(1, (keys.size() + keys_per_block - 1) / keys_per_block), Block{}) {
+    for (std::uint32_t key : keys) {
+        set(prefixes_, BinKey{key}.padded() / 100);
+        add(key);
+    }
+    if (ranges.empty()) return;
+    ranged_.assign(prefixes_.size(), 0);
+    for (const SnapshotRange& range : ranges) {
+        for (std::uint32_t prefix = range.first / 100; prefix <= range.last / 100; ++prefix) {
+            set(prefixes_, prefix);
+            set(ranged_, prefix);
+        }
+    }
+}
+
+void NegativeFilter::add(std::uint32_t key) noexcept {
+    const std::uint64_t h = hash(key);
+    Block& block = blocks_[block_of(h)];
+    const std::uint64_t bits = bit_positions(h);
+    for (std::size_t i = 0; i < 8; ++i) block.words[i] |= std::uint64_t{1} << (bits >> (6 * i) & 63);
+}
+
+auto NegativeFilter::memory_usage() const noexcept -> std::size_t {
+    return (prefixes_.capacity() + ranged_.capacity()) * sizeof(std::uint64_t) + blocks_.capacity() * sizeof(Block);
+}
+
+void NegativeFilter::memory_regions(std::vector<MemoryRegion>& out) const {
+    out.insert(out.end(), {memory_region(prefixes_), memory_region(ranged_), memory_region(blocks_)});
+}
+}
@@ -0,0 +1,93 @@
+#include "numa.hpp"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace LibBIN {
+
+// Parses a sysfs CPU or node list such as "0-3,8,10-11".
+static auto parse_list(const std::string& text) -> std::vector<unsigned> {
+    std::vector<unsigned> out;
+    std::stringstream items(text);
+    std::string item;
+    while (std::getline(items, item, ',')) {
+        if (item.empty() || item == "\n") continue;
+        auto dash = item.find('-');
+        unsigned first = static_cast<unsigned>(std::stoul(item.substr(0, dash)));
+        unsigned last = dash == std::string::npos ? first : static_cast<unsigned>(std::stoul(item.substr(dash + 1)));
+        for (unsigned i = first; i <= last; ++i) out.push_back(i);
+    }
+    return out;
+}
+
+static auto read_list(const std::string& path) -> std::vector<unsigned> {
+    std::ifstream in(path);
+    std::string text;
+    if (!std::getline(in, text)) return {};
+    try {
+        return parse_list(text);
+    } catch (const std::exception&) {
+        return {};
+    }
+}
+
+static auto node_path(unsigned node) -> std::string {
+    return "/sys/devices/system/node/node" + std::to_string(node) + "/cpulist";
+}
+
+auto NumaTopology::get() -> const NumaTopology& {
+    static const NumaTopology topology = [] {
+        NumaTopology t;
+        t.nodes = read_list("/sys/devices/system/node/online");
+        if (t.nodes.empty()) t.nodes = {0};
+        for (unsigned node : t.nodes) {
+            for (unsigned cpu : read_list(node_path(node))) {
+                if (cpu >= t.cpu_node.size()) t.cpu_node.resize(cpu + 1, 0);
+                t.cpu_node[cpu] = node;
+            }
+        }
+        return t;
+    }();
+    return topology;
+}
+
+auto NumaTopology::cpus(unsigned node) const -> std::vector<unsigned> {
+    std::vector<unsigned> out;
+    for (unsigned cpu = 0; cpu < cpu_node.size(); ++cpu) {
+        if (cpu_node[cpu] == node) out.push_back(cpu);
+    }
+    return out;
+}
+
+auto current_numa_node() noexcept -> unsigned {
+    const auto& cpu_node = NumaTopology::get().cpu_node;
+    int cpu = ::sched_getcpu();
+    if (cpu < 0 || static_cast<std::size_t>(cpu) >= cpu_node.size()) return 0;
+    return cpu_node[static_cast<std::size_t>(cpu)];
+}
+
+auto bind_thread_to_numa_node(unsigned node) -> bool {
+    auto cpus = NumaTopology::get().cpus(node);
+    if (cpus.empty()) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (unsigned cpu : cpus) {
+        if (cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+    }
+    if (::sched_setaffinity(0, sizeof(set), &set) != 0) return false;
+
+#ifdef SYS_set_mempolicy
+    // MPOL_PREFERRED, without pulling in libnuma's headers.
+    constexpr int mpol_preferred = 1;
+    constexpr unsigned long bits = 8 * sizeof(unsigned long);
+    std::vector<unsigned long> mask(node / bits + 1, 0);
+    mask[node / bits] |= 1ul << (node % bits);
+    ::syscall(SYS_set_mempolicy, mpol_preferred, mask.data(), mask.size() * bits + 1);
+#endif
+    return true;
+}
+}
@@ -0,0 +1,31 @@
+#include "packed_columns.hpp"
+
+namespace LibBIN {
+
+PackedColumns::PackedColumns(std::span<const unsigned> widths, std::size_t rows) {
+    widths_.reserve(widths.size());
+    offsets_.reserve(widths.size());
+    for (unsigned width : widths) {
+        offsets_.push_back(static_cast<std::uint16_t>(row_bits_));
+        widths_.push_back(static_cast<std::uint8_t>(width));
+        row_bits_ += width;
+    }
+    // Padding so the 8-byte read for the last row stays in bounds.
+    bits_.assign((rows * row_bits_ + 7) / 8 + sizeof(std::uint64_t), 0);
+}
+
+void PackedColumns::set(std::size_t row, std::size_t column, std::uint32_t value) noexcept {
+    std::size_t bit = row * row_bits_ + offsets_[column];
+    for (unsigned i = 0; i < widths_[column]; ++i, ++bit) {
+        if ((value >> i) & 1) bits_[bit / 8] |= static_cast<std::uint8_t>(1u << (bit % 8));
+    }
+}
+
+auto PackedColumns::memory_usage() const noexcept -> std::size_t {
+    return bits_.capacity() + widths_.capacity() + offsets_.capacity() * sizeof(std::uint16_t);
+}
+
+void PackedColumns::memory_regions(std::vector<MemoryRegion>& out) const {
+    out.insert(out.end(), {memory_region(bits_), memory_region(widths_), memory_region(offsets_)});
+}
+}
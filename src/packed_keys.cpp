@@ -0,0 +1,78 @@
+#include "packed_keys.hpp"
+#include <algorithm>
+#include <bit>
+
+namespace LibBIN {
+
+PackedKeys::PackedKeys(std::span<const std::uint32_t> keys) : size_(keys.size()) {
+    const std::size_t block_count = (keys.size() + block_keys - 1) / block_keys;
+    firsts_.reserve(block_count);
+    blocks_.reserve(block_count);
+    for (std::size_t first = 0; first < keys.size(); first += block_keys) {
+        auto block_span = keys.subspan(first, std::min(block_keys, keys.size() - first));
+        Block block;
+        block.bytes = static_cast<std::uint32_t>(offsets_.size());
+        block.text = static_cast<std::uint32_t>(text_.size());
+        block.width = static_cast<std::uint8_t>(std::bit_width(block_span.back() - block_span.front()));
+
+        std::vector<std::uint8_t> bits((block_span.size() * block.width + 7) / 8, 0);
+        for (std::size_t j = 0; j < block_span.size(); ++j) {
+            BinKey key{block_span[j]};
+            if (key.digits() == 7) block.seven |= std::uint64_t{1} << j;
+            if (key.digits() == 8) block.eight |= std::uint64_t{1} << j;
+            auto digits = key.to_string();
+            text_.insert(text_.end(), digits.begin(), digits.end());
+
+            std::uint32_t value = block_span[j] - block_span.front();
+            for (std::size_t i = 0; i < block.width; ++i) {
+                std::size_t bit = j * block.width + i;
+                if ((value >> i) & 1) bits[bit / 8] |= static_cast<std::uint8_t>(1u << (bit % 8));
+            }
+        }
+        offsets_.insert(offsets_.end(), bits.begin(), bits.end());
+        firsts_.push_back(block_span.front());
+        blocks_.push_back(block);
+    }
+    // Padding so the 8-byte read for the last offset stays in bounds.
+    offsets_.resize(offsets_.size() + sizeof(std::uint64_t), 0);
+    offsets_.shrink_to_fit();
+    text_.shrink_to_fit();
+}
+
+auto PackedKeys::find(BinKey key) const noexcept -> std::uint32_t {
+    std::size_t id = lower_bound(key);
+    if (id == size_ || this->key(id) != key) return npos;
+    return static_cast<std::uint32_t>(id);
+}
+
+auto PackedKeys::lower_bound(BinKey key) const noexcept -> std::size_t {
+    auto block_it = std::upper_bound(firsts_.begin(), firsts_.end(), key.packed);
+    if (block_it == firsts_.begin()) return 0;
+    const std::size_t b = static_cast<std::size_t>(block_it - firsts_.begin()) - 1;
+    const Block& block = blocks_[b];
+    const std::uint32_t target = key.packed - firsts_[b];
+
+    // Past the block's last key, the answer is the next block's first.
+    std::size_t lo = 0;
+    std::size_t n = std::min(block_keys, size_ - b * block_keys);
+    while (n > 0) {
+        std::size_t half = n / 2;
+        if (offset(block, lo + half) < target) {
+            lo += half + 1;
+            n -= half + 1;
+        } else {
+            n = half;
+        }
+    }
+    return b * block_keys + lo;
+}
+
+auto PackedKeys::memory_usage() const noexcept -> std::size_t {
+    return firsts_.capacity() * sizeof(std::uint32_t) + blocks_.capacity() * sizeof(Block) + offsets_.capacity()
+         + text_.capacity();
+}
+
+void PackedKeys::memory_regions(std::vector<MemoryRegion>& out) const {
+    out.insert(out.end(), {memory_region(firsts_), memory_region(blocks_), memory_region(offsets_), memory_region(text_)});
+}
+}
@@ -0,0 +1,102 @@
+#include "pan.hpp"
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define LIBBIN_X86 1
+#endif
+
+namespace LibBIN {
+
+// Digits are staged left-aligned in a '0'-filled buffer; the padding adds
+// nothing to the sum whether doubled or not.
+using DigitBuffer = std::array<char, 32>;
+
+static auto luhn_scalar(const DigitBuffer& digits, std::size_t n) noexcept -> bool {
+    constexpr std::uint8_t doubled[] = {0, 2, 4, 6, 8, 1, 3, 5, 7, 9};
+    unsigned sum = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        auto d = static_cast<unsigned>(digits[n - 1 - i] - '0');
+        sum += (i & 1) ? doubled[d] : d;
+    }
+    return sum % 10 == 0;
+}
+
+#ifdef LIBBIN_X86
+
+// Digit i is doubled when it lies an odd distance from the last digit,
+// i.e. when i and n have the same parity.
+__attribute__((target("ssse3")))
+static auto luhn_ssse3(const DigitBuffer& digits, std::size_t n) noexcept -> bool {
+    const __m128i zero = _mm_set1_epi8('0');
+    const __m128i doubled = _mm_setr_epi8(0, 2, 4, 6, 8, 1, 3, 5, 7, 9, 0, 0, 0, 0, 0, 0);
+    const __m128i even = _mm_setr_epi8(-1, 0, -1, 0, -1, 0, -1, 0, -1, 0, -1, 0, -1, 0, -1, 0);
+    const __m128i mask = n % 2 == 0 ? even : _mm_xor_si128(even, _mm_set1_epi8(-1));
+
+    __m128i lo = _mm_sub_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(digits.data())), zero);
+    __m128i hi = _mm_sub_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(digits.data() + 16)), zero);
+    lo = _mm_or_si128(_mm_and_si128(mask, _mm_shuffle_epi8(doubled, lo)), _mm_andnot_si128(mask, lo));
+    hi = _mm_or_si128(_mm_and_si128(mask, _mm_shuffle_epi8(doubled, hi)), _mm_andnot_si128(mask, hi));
+
+    const __m128i sums = _mm_add_epi64(_mm_sad_epu8(lo, _mm_setzero_si128()), _mm_sad_epu8(hi, _mm_setzero_si128()));
+    const auto sum = static_cast<unsigned>(_mm_cvtsi128_si32(sums) + _mm_cvtsi128_si32(_mm_srli_si128(sums, 8)));
+    return sum % 10 == 0;
+}
+
+#endif
+
+static auto luhn(const DigitBuffer& digits, std::size_t n, SimdLevel level) noexcept -> bool {
+#ifdef LIBBIN_X86
+    if (level != SimdLevel::Scalar) return luhn_ssse3(digits, n);
+#endif
+    (void)level;
+    return luhn_scalar(digits, n);
+}
+
+auto luhn_valid(std::string_view digits) noexcept -> bool {
+    return luhn_valid(digits, detected_simd_level());
+}
+
+auto luhn_valid(std::string_view digits, SimdLevel level) noexcept -> bool {
+    if (digits.empty() || digits.size() > sizeof(DigitBuffer)) return false;
+    if (!std::all_of(digits.begin(), digits.end(), [](char c) { return c >= '0' && c <= '9'; })) return false;
+    DigitBuffer buffer;
+    buffer.fill('0');
+    std::memcpy(buffer.data(), digits.data(), digits.size());
+    return luhn(buffer, digits.size(), std::min(level, detected_simd_level()));
+}
+
+// `level` is already clamped to the detected level.
+static auto parse_pan_at(std::string_view pan, SimdLevel level) noexcept -> std::expected<BinKey, ErrorCode> {
+    DigitBuffer digits;
+    digits.fill('0');
+    std::size_t n = 0;
+    for (char c : pan) {
+        if (c >= '0' && c <= '9') {
+            if (n == pan_max_digits) return std::unexpected{ErrorCode::InvalidFormat};
+            digits[n++] = c;
+        } else if (c != ' ' && c != '-') {
+            return std::unexpected{ErrorCode::InvalidFormat};
+        }
+    }
+    if (n < pan_min_digits) return std::unexpected{ErrorCode::InvalidFormat};
+    if (!luhn(digits, n, level)) return std::unexpected{ErrorCode::InvalidChecksum};
+    return *parse_bin(std::string_view(digits.data(), BinKey::max_digits), level);
+}
+
+auto parse_pan(std::string_view pan) noexcept -> std::expected<BinKey, ErrorCode> {
+    return parse_pan_at(pan, detected_simd_level());
+}
+
+auto parse_pan(std::string_view pan, SimdLevel level) noexcept -> std::expected<BinKey, ErrorCode> {
+    return parse_pan_at(pan, std::min(level, detected_simd_level()));
+}
+
+void parse_pans(std::span<const std::string_view> pans, std::span<std::expected<BinKey, ErrorCode>> out) noexcept {
+    const std::size_t count = std::min(pans.size(), out.size());
+    const SimdLevel level = detected_simd_level();
+    for (std::size_t i = 0; i < count; ++i) out[i] = parse_pan_at(pans[i], level);
+}
+}
@@ -0,0 +1,179 @@
+#include "perfect_hash.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace LibBIN {
+
+// Keys per bucket, and the spare positions the placement table gets over
+// the key count: a few percent keeps the pilot search for the last,
+// single-key buckets short.
+static constexpr std::size_t keys_per_bucket = 4;
+static constexpr std::size_t spare_divisor = 32;
+static constexpr unsigned max_seeds = 16;
+
+static auto pilots_bytes(std::size_t buckets) noexcept -> std::size_t {
+    return (buckets * sizeof(std::uint16_t) + 3) & ~std::size_t{3};
+}
+
+auto PerfectHash::build(std::span<const std::uint32_t> keys) -> std::optional<PerfectHash> {
+    PerfectHash result;
+    const std::size_t n = keys.size();
+    if (n == 0) return result;
+    result.bucket_count_ = (n + keys_per_bucket - 1) / keys_per_bucket;
+    result.table_size_ = n + n / spare_divisor + 1;
+    result.slot_count_ = n;
+
+    std::vector<std::uint64_t> hashes(n);
+    std::vector<std::uint32_t> order(n);
+    std::vector<std::uint32_t> starts(result.bucket_count_ + 1);
+    std::vector<std::uint32_t> buckets(result.bucket_count_);
+    std::vector<std::uint32_t> positions(n);
+    std::vector<bool> taken(result.table_size_);
+    std::vector<std::size_t> candidates;
+
+    for (unsigned attempt = 0; attempt < max_seeds; ++attempt) {
+        result.seed_ = mix(0x6c62696e00000000ull + attempt);
+        result.owned_pilots_.assign(result.bucket_count_, 0);
+        std::fill(taken.begin(), taken.end(), false);
+
+        // Group key indexes by bucket (counting sort), then order buckets
+        // largest first.
+        std::fill(starts.begin(), starts.end(), 0);
+        for (std::size_t i = 0; i < n; ++i) {
+            hashes[i] = hash(keys[i], result.seed_);
+            ++starts[bucket(hashes[i], result.bucket_count_) + 1];
+        }
+        for (std::size_t b = 0; b < result.bucket_count_; ++b) starts[b + 1] += starts[b];
+        {
+            std::vector<std::uint32_t> fill(starts.begin(), starts.end() - 1);
+            for (std::size_t i = 0; i < n; ++i) {
+                order[fill[bucket(hashes[i], result.bucket_count_)]++] = static_cast<std::uint32_t>(i);
+            }
+        }
+        for (std::size_t b = 0; b < result.bucket_count_; ++b) buckets[b] = static_cast<std::uint32_t>(b);
+        std::stable_sort(buckets.begin(), buckets.end(), [&](std::uint32_t a, std::uint32_t b) {
+            return starts[a + 1] - starts[a] > starts[b + 1] - starts[b];
+        });
+
+        bool placed = true;
+        for (std::uint32_t b : buckets) {
+            const std::uint32_t first = starts[b];
+            const std::uint32_t last = starts[b + 1];
+            if (first == last) break;
+            bool found = false;
+            for (std::uint32_t pilot = 0; pilot <= 0xFFFF && !found; ++pilot) {
+                candidates.clear();
+                found = true;
+                for (std::uint32_t k = first; k < last; ++k) {
+                    std::size_t p = position(hashes[order[k]], static_cast<std::uint16_t>(pilot), result.table_size_);
+                    if (taken[p] || std::find(candidates.begin(), candidates.end(), p) != candidates.end()) {
+                        found = false;
+                        break;
+                    }
+                    candidates.push_back(p);
+                }
+                if (found) {
+                    result.owned_pilots_[b] = static_cast<std::uint16_t>(pilot);
+                    for (std::uint32_t k = first; k < last; ++k) {
+                        taken[candidates[k - first]] = true;
+                        positions[order[k]] = static_cast<std::uint32_t>(candidates[k - first]);
+                    }
+                }
+            }
+            if (!found) {
+                placed = false;
+                break;
+            }
+        }
+        if (!placed) continue;
+
+        // Exactly n positions are taken, so the free slots below n match
+        // the taken positions at or past it one for one.
+        result.owned_remap_.assign(result.table_size_ - n, 0);
+        std::size_t free_slot = 0;
+        for (std::size_t p = n; p < result.table_size_; ++p) {
+            if (!taken[p]) continue;
+            while (taken[free_slot]) ++free_slot;
+            result.owned_remap_[p - n] = static_cast<std::uint32_t>(free_slot++);
+        }
+        result.owned_ids_.resize(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            std::size_t p = positions[i] < n ? positions[i] : result.owned_remap_[positions[i] - n];
+            result.owned_ids_[p] = static_cast<std::uint32_t>(i);
+        }
+        result.pilots_ = result.owned_pilots_.data();
+        result.remap_ = result.owned_remap_.data();
+        result.ids_ = result.owned_ids_.data();
+        result.keys_ = keys;
+        return result;
+    }
+    return std::nullopt;
+}
+
+auto PerfectHash::view(std::span<const std::byte> bytes, std::span<const std::uint32_t> keys)
+    -> std::optional<PerfectHash> {
+    Header header{};
+    if (bytes.size() < sizeof(header)) return std::nullopt;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (header.slot_count != keys.size() || header.table_size < header.slot_count
+        || (header.slot_count > 0 && header.bucket_count == 0)) {
+        return std::nullopt;
+    }
+    const std::size_t remap_count = header.table_size - header.slot_count;
+    const std::size_t pilots_size = pilots_bytes(header.bucket_count);
+    const std::size_t remap_size = remap_count * sizeof(std::uint32_t);
+    if (bytes.size() != sizeof(header) + pilots_size + remap_size + std::size_t{header.slot_count} * sizeof(std::uint32_t)) {
+        return std::nullopt;
+    }
+
+    PerfectHash result;
+    result.seed_ = header.seed;
+    result.bucket_count_ = header.bucket_count;
+    result.table_size_ = header.table_size;
+    result.slot_count_ = header.slot_count;
+    const std::byte* data = bytes.data() + sizeof(header);
+    result.pilots_ = reinterpret_cast<const std::uint16_t*>(data);
+    result.remap_ = reinterpret_cast<const std::uint32_t*>(data + pilots_size);
+    result.ids_ = reinterpret_cast<const std::uint32_t*>(data + pilots_size + remap_size);
+    result.keys_ = keys;
+    // Ids and remapped positions index other tables; keep them in bounds.
+    for (std::size_t i = 0; i < remap_count; ++i) {
+        if (result.remap_[i] >= result.slot_count_) return std::nullopt;
+    }
+    for (std::size_t i = 0; i < result.slot_count_; ++i) {
+        if (result.ids_[i] >= keys.size()) return std::nullopt;
+    }
+    return result;
+}
+
+auto PerfectHash::serialize() const -> std::vector<std::byte> {
+    const Header header{
+        seed_,
+        static_cast<std::uint32_t>(bucket_count_),
+        static_cast<std::uint32_t>(table_size_),
+        static_cast<std::uint32_t>(slot_count_),
+        0,
+    };
+    const std::size_t pilots_size = pilots_bytes(bucket_count_);
+    const std::size_t remap_size = (table_size_ - slot_count_) * sizeof(std::uint32_t);
+    std::vector<std::byte> out(sizeof(header) + pilots_size + remap_size + slot_count_ * sizeof(std::uint32_t));
+    std::byte* data = out.data();
+    std::memcpy(data, &header, sizeof(header));
+    data += sizeof(header);
+    if (bucket_count_ > 0) std::memcpy(data, pilots_, bucket_count_ * sizeof(std::uint16_t));
+    data += pilots_size;
+    if (remap_size > 0) std::memcpy(data, remap_, remap_size);
+    data += remap_size;
+    if (slot_count_ > 0) std::memcpy(data, ids_, slot_count_ * sizeof(std::uint32_t));
+    return out;
+}
+
+auto PerfectHash::memory_usage() const noexcept -> std::size_t {
+    return owned_pilots_.capacity() * sizeof(std::uint16_t) + owned_remap_.capacity() * sizeof(std::uint32_t)
+         + owned_ids_.capacity() * sizeof(std::uint32_t);
+}
+
+void PerfectHash::memory_regions(std::vector<MemoryRegion>& out) const {
+    out.insert(out.end(), {memory_region(owned_pilots_), memory_region(owned_remap_), memory_region(owned_ids_)});
+}
+}
@@ -0,0 +1,71 @@
+#include "prefix_index.hpp"
+
+namespace LibBIN {
+
+static constexpr std::uint32_t digit_divisors[] = {100, 10, 1};
+
+PrefixIndex::PrefixIndex(std::span<const std::uint32_t> keys) : root_(1'000'000, npos) {
+    // Slots are updated through pointers into nodes_, so it must not reallocate.
+    std::size_t max_nodes = 0;
+    for (auto packed : keys) max_nodes += BinKey{packed}.digits() - BinKey::min_digits;
+    nodes_.reserve(max_nodes);
+
+    for (std::size_t id = 0; id < keys.size(); ++id) {
+        BinKey key{keys[id]};
+        std::uint32_t* slot = &root_[key.padded() / 100];
+        for (std::size_t depth = BinKey::min_digits; depth < key.digits(); ++depth) {
+            slot = &descend(*slot).slots[key.padded() / digit_divisors[depth - BinKey::min_digits + 1] % 10];
+        }
+        if (*slot != npos && (*slot & node_bit) != 0) {
+            nodes_[*slot & ~node_bit].self = static_cast<std::uint32_t>(id);
+        } else {
+            *slot = static_cast<std::uint32_t>(id);
+        }
+    }
+    nodes_.shrink_to_fit();
+}
+
+auto PrefixIndex::descend(std::uint32_t& slot) -> Node& {
+    if (slot == npos || (slot & node_bit) == 0) {
+        Node node;
+        node.self = slot;
+        node.slots.fill(npos);
+        nodes_.push_back(node);
+        slot = static_cast<std::uint32_t>(nodes_.size() - 1) | node_bit;
+    }
+    return nodes_[slot & ~node_bit];
+}
+
+auto PrefixIndex::find(BinKey key) const noexcept -> std::uint32_t {
+    if (root_.empty()) return npos;
+    std::uint32_t slot = root_[key.padded() / 100];
+    for (std::size_t depth = BinKey::min_digits; depth < key.digits(); ++depth) {
+        if (slot == npos || (slot & node_bit) == 0) return npos;
+        slot = nodes_[slot & ~node_bit].slots[key.padded() / digit_divisors[depth - BinKey::min_digits + 1] % 10];
+    }
+    if (slot != npos && (slot & node_bit) != 0) return nodes_[slot & ~node_bit].self;
+    return slot;
+}
+
+auto PrefixIndex::find_longest(BinKey key) const noexcept -> std::uint32_t {
+    if (root_.empty()) return npos;
+    std::uint32_t best = npos;
+    std::uint32_t slot = root_[key.padded() / 100];
+    for (std::size_t depth = BinKey::min_digits;; ++depth) {
+        if (slot == npos) return best;
+        if ((slot & node_bit) == 0) return slot;
+        const Node& node = nodes_[slot & ~node_bit];
+        if (node.self != npos) best = node.self;
+        if (depth == key.digits()) return best;
+        slot = node.slots[key.padded() / digit_divisors[depth - BinKey::min_digits + 1] % 10];
+    }
+}
+
+auto PrefixIndex::memory_usage() const noexcept -> std::size_t {
+    return root_.capacity() * sizeof(std::uint32_t) + nodes_.capacity() * sizeof(Node);
+}
+
+void PrefixIndex::memory_regions(std::vector<MemoryRegion>& out) const {
+    out.insert(out.end(), {memory_region(root_), memory_region(nodes_)});
+}
+}
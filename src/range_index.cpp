@@ -0,0 +1,21 @@
+#include "range_index.hpp"
+
+namespace LibBIN {
+
+RangeIndex::RangeIndex(std::span<const SnapshotRange> ranges, std::uint32_t first_id) : first_id_(first_id) {
+    firsts_.reserve(ranges.size());
+    lasts_.reserve(ranges.size());
+    for (const auto& range : ranges) {
+        firsts_.push_back(range.first);
+        lasts_.push_back(range.last);
+    }
+}
+
+auto RangeIndex::memory_usage() const noexcept -> std::size_t {
+    return (firsts_.capacity() + lasts_.capacity()) * sizeof(std::uint32_t);
+}
+
+void RangeIndex::memory_regions(std::vector<MemoryRegion>& out) const {
+    out.insert(out.end(), {memory_region(firsts_), memory_region(lasts_)});
+}
+}
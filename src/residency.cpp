@@ -0,0 +1,81 @@
+#include "residency.hpp"
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace LibBIN {
+
+static constexpr std::uintptr_t huge_page_size = std::uintptr_t{2} << 20;
+
+static auto page_size() noexcept -> std::uintptr_t {
+    static const auto size = static_cast<std::uintptr_t>(::sysconf(_SC_PAGESIZE));
+    return size;
+}
+
+// The region widened to whole pages of `page`, as madvise and mlock expect.
+static auto page_span(MemoryRegion region, std::uintptr_t page) noexcept -> std::pair<void*, std::size_t> {
+    auto begin = reinterpret_cast<std::uintptr_t>(region.data()) & ~(page - 1);
+    auto end = reinterpret_cast<std::uintptr_t>(region.data() + region.size());
+    return {reinterpret_cast<void*>(begin), end - begin};
+}
+
+// The whole pages of `page` lying entirely inside the region; empty if none.
+// Pages at either end may be shared with other allocations.
+static auto interior_span(MemoryRegion region, std::uintptr_t page) noexcept -> std::pair<void*, std::size_t> {
+    auto begin = (reinterpret_cast<std::uintptr_t>(region.data()) + page - 1) & ~(page - 1);
+    auto end = reinterpret_cast<std::uintptr_t>(region.data() + region.size()) & ~(page - 1);
+    return {reinterpret_cast<void*>(begin), end > begin ? end - begin : 0};
+}
+
+void advise_huge_pages(std::span<const MemoryRegion> regions) noexcept {
+#ifdef MADV_HUGEPAGE
+    for (auto region : regions) {
+        auto [start, length] = interior_span(region, huge_page_size);
+        if (length != 0) ::madvise(start, length, MADV_HUGEPAGE);
+    }
+#else
+    (void)regions;
+#endif
+}
+
+void prefault(std::span<const MemoryRegion> regions) noexcept {
+    for (auto region : regions) {
+        if (region.empty()) continue;
+#ifdef MADV_POPULATE_READ
+        auto [start, length] = page_span(region, page_size());
+        if (::madvise(start, length, MADV_POPULATE_READ) == 0) continue;
+#endif
+        // Older kernels: read one byte per page.
+        const volatile std::byte* bytes = region.data();
+        for (std::size_t i = 0; i < region.size(); i += page_size()) (void)bytes[i];
+        (void)bytes[region.size() - 1];
+    }
+}
+
+auto lock_memory(std::span<const MemoryRegion> regions) -> std::expected<void, LookupError> {
+    for (std::size_t i = 0; i < regions.size(); ++i) {
+        if (regions[i].empty()) continue;
+        auto [start, length] = page_span(regions[i], page_size());
+        if (::mlock(start, length) != 0) {
+            int err = errno;
+            unlock_memory(regions.first(i));
+            return std::unexpected{LookupError(std::format("Failed to lock BIN database in memory: {}", std::strerror(err)))};
+        }
+    }
+    return {};
+}
+
+// mlock is not reference-counted, so only pages no other allocation can be
+// using are unlocked: a small table's partial pages may also belong to the
+// next database, which is still locked. They stay locked until reused or the
+// process exits.
+void unlock_memory(std::span<const MemoryRegion> regions) noexcept {
+    for (auto region : regions) {
+        auto [start, length] = interior_span(region, page_size());
+        if (length != 0) ::munlock(start, length);
+    }
+}
+}
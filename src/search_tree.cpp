@@ -0,0 +1,61 @@
+#include "search_tree.hpp"
+#include <algorithm>
+
+namespace LibBIN {
+
+SearchTree::SearchTree(std::span<const std::uint32_t> keys) : size_(keys.size()) {
+    if (keys.empty()) return;
+
+    // Node counts per level, leaves first.
+    std::vector<std::size_t> counts = {(keys.size() + node_keys - 1) / node_keys};
+    while (counts.back() > 1) counts.push_back((counts.back() + fanout - 1) / fanout);
+    std::reverse(counts.begin(), counts.end());
+    std::size_t total = 0;
+    for (std::size_t count : counts) {
+        levels_.push_back(total);
+        total += count;
+    }
+    nodes_.resize(total);
+
+    // Leaves, then each inner level from the smallest key under each child.
+    std::vector<std::uint32_t> mins(counts.back());
+    for (std::size_t i = 0; i < counts.back(); ++i) {
+        Node& leaf = nodes_[levels_.back() + i];
+        for (std::size_t j = 0; j < node_keys; ++j) {
+            std::size_t id = i * node_keys + j;
+            leaf.keys[j] = id < keys.size() ? static_cast<std::int32_t>(keys[id]) : padding;
+        }
+        mins[i] = keys[i * node_keys];
+    }
+    for (std::size_t level = levels_.size() - 1; level-- > 0;) {
+        std::vector<std::uint32_t> next(counts[level]);
+        for (std::size_t i = 0; i < counts[level]; ++i) {
+            Node& node = nodes_[levels_[level] + i];
+            for (std::size_t j = 0; j < node_keys; ++j) {
+                std::size_t child = i * fanout + j + 1;
+                node.keys[j] = child < mins.size() ? static_cast<std::int32_t>(mins[child]) : padding;
+            }
+            next[i] = mins[i * fanout];
+        }
+        mins = std::move(next);
+    }
+}
+
+void SearchTree::prefetch(BinKey key) const noexcept {
+    if (size_ == 0) return;
+    const auto target = static_cast<std::int32_t>(key.packed);
+    std::size_t k = 0;
+    for (std::size_t level = 0; level + 1 < levels_.size(); ++level) {
+        k = k * fanout + count_less(nodes_[levels_[level] + k], target);
+    }
+    __builtin_prefetch(&nodes_[levels_.back() + k]);
+}
+
+auto SearchTree::memory_usage() const noexcept -> std::size_t {
+    return nodes_.capacity() * sizeof(Node) + levels_.capacity() * sizeof(std::size_t);
+}
+
+void SearchTree::memory_regions(std::vector<MemoryRegion>& out) const {
+    out.push_back(memory_region(nodes_));
+}
+}
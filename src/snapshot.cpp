@@ -0,0 +1,519 @@
+#include "snapshot.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <span>
+#include <unordered_map>
+
+namespace LibBIN {
+
+static_assert(std::endian::native == std::endian::little, "snapshot format is little-endian");
+
+static auto align_up(std::size_t value) -> std::size_t {
+    return (value + snapshot_alignment - 1) & ~(snapshot_alignment - 1);
+}
+
+// The largest 8-digit value a key or range bound can pad to.
+static constexpr std::uint32_t max_padded = 99'999'999;
+
+// True for a packed key BinKey::parse could have produced: 6-8 digits, at
+// most eight places, and zeros past its last digit.
+static constexpr auto valid_key(std::uint32_t packed) noexcept -> bool {
+    constexpr std::uint32_t scale[] = {100, 10, 1};
+    BinKey key{packed};
+    return (packed & 3u) != 3u && key.padded() <= max_padded && key.padded() % scale[packed & 3u] == 0;
+}
+
+auto Snapshot::open(const std::string& path, bool populate) -> std::expected<Snapshot, LookupError> {
+    auto file = MappedFile::open(path, populate);
+    if (!file) {
+        return std::unexpected{file.error()};
+    }
+    auto snapshot = parse(file->bytes(), path);
+    if (snapshot) {
+        snapshot->file_ = std::move(*file);
+    }
+    return snapshot;
+}
+
+auto Snapshot::from_image(std::vector<std::byte> image) -> std::expected<Snapshot, LookupError> {
+    auto snapshot = parse(image, "<memory>");
+    if (snapshot) {
+        snapshot->image_ = std::move(image);
+    }
+    return snapshot;
+}
+
+auto Snapshot::parse(std::span<const std::byte> image, std::string_view name) -> std::expected<Snapshot, LookupError> {
+    auto invalid = [&](std::string_view reason) {
+        return std::unexpected{LookupError(std::format("Invalid snapshot {}: {}", name, reason))};
+    };
+
+    const std::byte* base = image.data();
+    const std::size_t size = image.size();
+    SnapshotHeader header{};
+    if (size < sizeof(header)) return invalid("truncated header");
+    std::memcpy(&header, base, sizeof(header));
+    if (std::memcmp(header.magic, snapshot_magic, sizeof(snapshot_magic)) != 0) return invalid("bad magic");
+    if (header.version != snapshot_version) {
+        return invalid(std::format("unsupported version {}", header.version));
+    }
+    if (header.file_size != size) return invalid("size mismatch");
+    if (sizeof(header) + std::size_t{header.section_count} * sizeof(SnapshotSection) > size) {
+        return invalid("truncated section table");
+    }
+
+    Snapshot snapshot;
+    snapshot.count_ = header.record_count;
+    snapshot.image_size_ = size;
+    bool has_keys = false, has_records = false, has_dictionaries = false, has_strings = false;
+    std::size_t dictionary_value_count = 0;
+    std::span<const std::byte> perfect_hash;
+    for (std::size_t i = 0; i < header.section_count; ++i) {
+        SnapshotSection section{};
+        std::memcpy(&section, base + sizeof(header) + i * sizeof(section), sizeof(section));
+        if (section.offset > size || section.size > size - section.offset || section.offset % alignof(std::uint32_t) != 0) {
+            return invalid("section out of bounds");
+        }
+        const std::byte* data = base + section.offset;
+        if (section.tag == snapshot_keys_tag) {
+            if (section.size % sizeof(std::uint32_t) != 0) return invalid("key table size");
+            snapshot.keys_ = reinterpret_cast<const std::uint32_t*>(data);
+            snapshot.key_count_ = section.size / sizeof(std::uint32_t);
+            has_keys = true;
+        } else if (section.tag == snapshot_ranges_tag) {
+            if (section.size % sizeof(SnapshotRange) != 0) return invalid("range table size");
+            snapshot.ranges_ = reinterpret_cast<const SnapshotRange*>(data);
+            snapshot.range_count_ = section.size / sizeof(SnapshotRange);
+        } else if (section.tag == snapshot_records_tag) {
+            if (section.size != snapshot.count_ * sizeof(SnapshotRecord)) return invalid("record table size");
+            snapshot.records_ = reinterpret_cast<const SnapshotRecord*>(data);
+            has_records = true;
+        } else if (section.tag == snapshot_dictionaries_tag) {
+            constexpr std::size_t directory_size = record_field_count * sizeof(SnapshotDictionary);
+            if (section.size < directory_size || (section.size - directory_size) % sizeof(SnapshotString) != 0) {
+                return invalid("dictionary table size");
+            }
+            std::memcpy(snapshot.dictionaries_.data(), data, directory_size);
+            snapshot.dictionary_values_ = reinterpret_cast<const SnapshotString*>(data + directory_size);
+            dictionary_value_count = (section.size - directory_size) / sizeof(SnapshotString);
+            has_dictionaries = true;
+        } else if (section.tag == snapshot_strings_tag) {
+            snapshot.strings_ = reinterpret_cast<const char*>(data);
+            snapshot.strings_size_ = section.size;
+            has_strings = true;
+        } else if (section.tag == snapshot_perfect_hash_tag) {
+            perfect_hash = {data, section.size};
+        }
+    }
+    if (!has_keys || !has_records || !has_dictionaries || !has_strings) return invalid("missing section");
+    for (const auto& dict : snapshot.dictionaries_) {
+        if (dict.first > dictionary_value_count || dict.count > dictionary_value_count - dict.first) {
+            return invalid("dictionary out of bounds");
+        }
+    }
+    if (snapshot.key_count_ + snapshot.range_count_ != snapshot.count_) return invalid("record count");
+    // Indexes address tables by a key's 6-digit prefix and digit count, and
+    // find() binary-searches the keys.
+    for (std::size_t i = 0; i < snapshot.key_count_; ++i) {
+        if (!valid_key(snapshot.keys_[i]) || (i > 0 && snapshot.keys_[i - 1] >= snapshot.keys_[i])) {
+            return invalid("key table");
+        }
+    }
+    for (std::size_t i = 0; i < snapshot.range_count_; ++i) {
+        if (snapshot.ranges_[i].first > snapshot.ranges_[i].last || snapshot.ranges_[i].last > max_padded
+            || (i > 0 && snapshot.ranges_[i - 1].last >= snapshot.ranges_[i].first)) {
+            return invalid("unsorted or overlapping ranges");
+        }
+    }
+    if (!perfect_hash.empty()) {
+        auto hash = PerfectHash::view(perfect_hash, snapshot.keys());
+        if (!hash) return invalid("perfect hash");
+        snapshot.perfect_hash_ = std::move(*hash);
+    }
+    return snapshot;
+}
+
+auto Snapshot::find(BinKey key) const noexcept -> std::optional<std::uint32_t> {
+    std::size_t id = lower_bound(key);
+    if (id == key_count_ || this->key(id) != key) return std::nullopt;
+    return static_cast<std::uint32_t>(id);
+}
+
+auto Snapshot::lower_bound(BinKey key) const noexcept -> std::size_t {
+    if (packed_) return packed_keys_.lower_bound(key);
+    return static_cast<std::size_t>(std::lower_bound(keys_, keys_ + key_count_, key.packed) - keys_);
+}
+
+void Snapshot::pack() {
+    if (packed_) return;
+    PackedKeys keys(this->keys());
+
+    // One column per dictionary id, just wide enough for its dictionary,
+    // then the flag bits.
+    std::array<unsigned, record_field_count + 1> widths{};
+    for (std::size_t f = 0; f < record_field_count; ++f) {
+        widths[f] = static_cast<unsigned>(std::bit_width(std::max<std::uint32_t>(dictionaries_[f].count, 1) - 1));
+    }
+    widths[record_field_count] = static_cast<unsigned>(std::bit_width(std::uint32_t{snapshot_prepaid | snapshot_valid}));
+    PackedColumns records(widths, count_);
+    for (std::size_t id = 0; id < count_; ++id) {
+        for (std::size_t f = 0; f < record_field_count; ++f) {
+            records.set(id, f, records_[id].id(static_cast<RecordField>(f)));
+        }
+        records.set(id, record_field_count, records_[id].flags);
+    }
+
+    // Dictionary values and range BINs are the only strings still needed;
+    // key BINs are kept by PackedKeys.
+    std::vector<char> strings;
+    auto copy = [&](SnapshotString ref) {
+        std::string_view text = string(ref);
+        SnapshotString copied{static_cast<std::uint32_t>(strings.size()), static_cast<std::uint32_t>(text.size())};
+        strings.insert(strings.end(), text.begin(), text.end());
+        return copied;
+    };
+    std::vector<SnapshotString> values;
+    auto dictionaries = dictionaries_;
+    for (auto& dict : dictionaries) {
+        std::uint32_t first = static_cast<std::uint32_t>(values.size());
+        for (std::uint32_t i = 0; i < dict.count; ++i) values.push_back(copy(dictionary_values_[dict.first + i]));
+        dict.first = first;
+    }
+    std::vector<SnapshotString> range_bins;
+    range_bins.reserve(range_count_);
+    for (std::size_t i = 0; i < range_count_; ++i) range_bins.push_back(copy(records_[key_count_ + i].bin));
+
+    packed_keys_ = std::move(keys);
+    packed_records_ = std::move(records);
+    packed_ranges_.assign(ranges_, ranges_ + range_count_);
+    packed_values_ = std::move(values);
+    range_bins_ = std::move(range_bins);
+    packed_strings_ = std::move(strings);
+
+    dictionaries_ = dictionaries;
+    keys_ = nullptr;
+    records_ = nullptr;
+    ranges_ = packed_ranges_.data();
+    dictionary_values_ = packed_values_.data();
+    strings_ = packed_strings_.data();
+    strings_size_ = packed_strings_.size();
+    packed_ = true;
+
+    perfect_hash_ = PerfectHash{};
+    file_ = MappedFile{};
+    image_ = std::vector<std::byte>{};
+    image_size_ = 0;
+}
+
+auto Snapshot::memory_usage() const noexcept -> std::size_t {
+    return image_size_ + packed_keys_.memory_usage() + packed_records_.memory_usage()
+         + packed_ranges_.capacity() * sizeof(SnapshotRange)
+         + (packed_values_.capacity() + range_bins_.capacity()) * sizeof(SnapshotString) + packed_strings_.capacity();
+}
+
+auto Snapshot::copy(bool huge_pages) const -> std::expected<Snapshot, LookupError> {
+    if (packed_) {
+        return std::unexpected{LookupError("Cannot copy a packed snapshot")};
+    }
+    auto image = file_.data() ? file_.bytes() : std::span<const std::byte>(image_);
+    auto region = MappedFile::copy(image, huge_pages);
+    if (!region) {
+        return std::unexpected{region.error()};
+    }
+    auto copied = parse(region->bytes(), "<copy>");
+    if (copied) {
+        copied->file_ = std::move(*region);
+    }
+    return copied;
+}
+
+auto Snapshot::move_to_huge_pages() -> std::expected<void, LookupError> {
+    if (packed_) return {};
+    auto moved = copy(true);
+    if (!moved) {
+        return std::unexpected{moved.error()};
+    }
+    *this = std::move(*moved);
+    return {};
+}
+
+void Snapshot::memory_regions(std::vector<MemoryRegion>& out) const {
+    if (file_.data()) out.push_back(file_.bytes());
+    if (!image_.empty()) out.push_back(memory_region(image_));
+    if (!packed_) return;
+    packed_keys_.memory_regions(out);
+    packed_records_.memory_regions(out);
+    out.insert(out.end(), {memory_region(packed_ranges_), memory_region(packed_values_), memory_region(range_bins_),
+                           memory_region(packed_strings_)});
+}
+
+auto Snapshot::record(std::uint32_t index) const -> Result {
+    Result r{};
+    r.bin = bin(index);
+    r.scheme = field(index, RecordField::Scheme);
+    r.type = field(index, RecordField::Type);
+    r.brand = field(index, RecordField::Brand);
+    r.bank = field(index, RecordField::Bank);
+    r.country = field(index, RecordField::Country);
+    r.country_code = field(index, RecordField::CountryCode);
+    r.level = field(index, RecordField::Level);
+    r.country_flag = field(index, RecordField::CountryFlag);
+    r.prepaid = (flags(index) & snapshot_prepaid) != 0;
+    r.is_valid = (flags(index) & snapshot_valid) != 0;
+    return r;
+}
+
+auto SnapshotWriter::add(const Result& result) -> bool {
+    return add(RecordFields{
+        result.bin, result.scheme, result.type, result.brand, result.bank,
+        result.country, result.country_code, result.level, result.country_flag,
+        result.prepaid, result.is_valid,
+    });
+}
+
+auto SnapshotWriter::add(const RecordFields& fields) -> bool {
+    if (auto key = parse_bin(fields.bin)) {
+        entries_.emplace_back(*key, encode(fields));
+        return true;
+    }
+    if (auto range = BinRange::parse(fields.bin)) {
+        ranges_.emplace_back(*range, encode(fields));
+        return true;
+    }
+    return false;
+}
+
+auto SnapshotWriter::intern(std::string_view text) -> SnapshotString {
+    if (auto it = interned_.find(text); it != interned_.end()) {
+        return {it->second, static_cast<std::uint32_t>(text.size())};
+    }
+    SnapshotString ref = append(text);
+    interned_.emplace(stored(ref), ref.offset);
+    return ref;
+}
+
+auto SnapshotWriter::append(std::string_view text) -> SnapshotString {
+    constexpr std::size_t block_size = 64 * 1024;
+    if (blocks_.empty() || blocks_.back().capacity - blocks_.back().size < text.size()) {
+        std::size_t capacity = std::max(block_size, text.size());
+        blocks_.push_back({std::make_unique<char[]>(capacity), 0, capacity});
+    }
+    StringBlock& block = blocks_.back();
+    if (!text.empty()) std::memcpy(block.data.get() + block.size, text.data(), text.size());
+    block.size += text.size();
+
+    SnapshotString ref{static_cast<std::uint32_t>(pool_size_), static_cast<std::uint32_t>(text.size())};
+    pool_size_ += text.size();
+    return ref;
+}
+
+// Only valid for the string most recently appended.
+auto SnapshotWriter::stored(SnapshotString ref) const noexcept -> std::string_view {
+    const StringBlock& block = blocks_.back();
+    return {block.data.get() + block.size - ref.size, ref.size};
+}
+
+auto SnapshotWriter::encode_field(RecordField field, std::string_view text) -> std::uint32_t {
+    auto f = static_cast<std::size_t>(field);
+    // Exports are sorted by BIN, so neighbouring rows often repeat a value.
+    if (auto [last, id] = last_ids_[f]; last.data() != nullptr && last == text) return id;
+    auto it = ids_[f].find(text);
+    if (it == ids_[f].end()) {
+        auto id = static_cast<std::uint32_t>(values_[f].size());
+        values_[f].push_back(intern(text));
+        // Key the id by the interned copy; `text` belongs to the caller.
+        it = ids_[f].emplace(interned_.find(text)->first, id).first;
+    }
+    last_ids_[f] = *it;
+    return it->second;
+}
+
+auto SnapshotWriter::encode(const RecordFields& r) -> SnapshotRecord {
+    auto small = [](std::uint32_t id) { return static_cast<std::uint16_t>(id); };
+    return SnapshotRecord{
+        append(r.bin),
+        encode_field(RecordField::Bank, r.bank),
+        small(encode_field(RecordField::Scheme, r.scheme)),
+        small(encode_field(RecordField::Type, r.type)),
+        small(encode_field(RecordField::Brand, r.brand)),
+        small(encode_field(RecordField::Country, r.country)),
+        small(encode_field(RecordField::CountryCode, r.country_code)),
+        small(encode_field(RecordField::Level, r.level)),
+        small(encode_field(RecordField::CountryFlag, r.country_flag)),
+        static_cast<std::uint16_t>((r.prepaid ? snapshot_prepaid : 0u) | (r.is_valid ? snapshot_valid : 0u)),
+    };
+}
+
+static constexpr auto by_key = [](const auto& a, const auto& b) { return a.first < b.first; };
+
+void SnapshotWriter::sort() {
+    if (!std::is_sorted(entries_.begin(), entries_.end(), by_key)) {
+        std::stable_sort(entries_.begin(), entries_.end(), by_key);
+    }
+    if (!std::is_sorted(ranges_.begin(), ranges_.end(), by_key)) {
+        std::stable_sort(ranges_.begin(), ranges_.end(), by_key);
+    }
+}
+
+void SnapshotWriter::merge(SnapshotWriter&& other) {
+    // Adopt the other pool wholesale: its strings keep their bytes and move
+    // up by the current pool size.
+    const auto shift = static_cast<std::uint32_t>(pool_size_);
+    for (auto& block : other.blocks_) blocks_.push_back(std::move(block));
+    pool_size_ += other.pool_size_;
+    for (const auto& [text, offset] : other.interned_) interned_.try_emplace(text, offset + shift);
+
+    std::array<std::vector<std::uint32_t>, record_field_count> remap;
+    for (std::size_t f = 0; f < record_field_count; ++f) {
+        remap[f].resize(other.values_[f].size());
+        for (const auto& [text, id] : other.ids_[f]) {
+            remap[f][id] = encode_field(static_cast<RecordField>(f), text);
+        }
+    }
+    auto small = [](std::uint32_t id) { return static_cast<std::uint16_t>(id); };
+    auto rebase = [&](SnapshotRecord r) {
+        r.bin.offset += shift;
+        r.bank = remap[static_cast<std::size_t>(RecordField::Bank)][r.bank];
+        r.scheme = small(remap[static_cast<std::size_t>(RecordField::Scheme)][r.scheme]);
+        r.type = small(remap[static_cast<std::size_t>(RecordField::Type)][r.type]);
+        r.brand = small(remap[static_cast<std::size_t>(RecordField::Brand)][r.brand]);
+        r.country = small(remap[static_cast<std::size_t>(RecordField::Country)][r.country]);
+        r.country_code = small(remap[static_cast<std::size_t>(RecordField::CountryCode)][r.country_code]);
+        r.level = small(remap[static_cast<std::size_t>(RecordField::Level)][r.level]);
+        r.country_flag = small(remap[static_cast<std::size_t>(RecordField::CountryFlag)][r.country_flag]);
+        return r;
+    };
+
+    auto append_run = [&](auto& into, auto& from) {
+        const bool sorted = std::is_sorted(into.begin(), into.end(), by_key) &&
+                            std::is_sorted(from.begin(), from.end(), by_key);
+        const std::size_t middle = into.size();
+        into.reserve(into.size() + from.size());
+        for (const auto& [key, record] : from) into.emplace_back(key, rebase(record));
+        // inplace_merge keeps this writer's records ahead of equal keys from
+        // `other`, so the last-added-wins rule still holds.
+        if (sorted) std::inplace_merge(into.begin(), into.begin() + static_cast<std::ptrdiff_t>(middle), into.end(), by_key);
+    };
+    append_run(entries_, other.entries_);
+    append_run(ranges_, other.ranges_);
+    other = SnapshotWriter{};
+}
+
+auto SnapshotWriter::serialize() -> std::expected<std::vector<std::byte>, LookupError> {
+    sort();
+    auto last = std::unique(entries_.rbegin(), entries_.rend(),
+                            [](const auto& a, const auto& b) { return a.first == b.first; });
+    entries_.erase(entries_.begin(), last.base());
+
+    auto last_range = std::unique(ranges_.rbegin(), ranges_.rend(),
+                                  [](const auto& a, const auto& b) { return a.first == b.first; });
+    ranges_.erase(ranges_.begin(), last_range.base());
+    overlapping_ranges_ = 0;
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < ranges_.size(); ++i) {
+        if (kept > 0 && ranges_[kept - 1].first.last >= ranges_[i].first.first) {
+            ++overlapping_ranges_;
+            continue;
+        }
+        if (kept != i) ranges_[kept] = std::move(ranges_[i]);
+        ++kept;
+    }
+    ranges_.resize(kept);
+
+    std::vector<std::uint32_t> keys;
+    std::vector<SnapshotRange> ranges;
+    std::vector<SnapshotRecord> records;
+    keys.reserve(entries_.size());
+    ranges.reserve(ranges_.size());
+    records.reserve(size());
+    for (const auto& [key, record] : entries_) {
+        keys.push_back(key.packed);
+        records.push_back(record);
+    }
+    for (const auto& [range, record] : ranges_) {
+        ranges.push_back({range.first, range.last});
+        records.push_back(record);
+    }
+    for (std::size_t f = 0; f < record_field_count; ++f) {
+        if (static_cast<RecordField>(f) != RecordField::Bank && values_[f].size() > 0x10000) {
+            return std::unexpected{LookupError(std::format("Too many distinct values for record field {}", f))};
+        }
+    }
+
+    std::vector<std::byte> dictionaries(record_field_count * sizeof(SnapshotDictionary));
+    for (std::size_t f = 0; f < record_field_count; ++f) {
+        SnapshotDictionary dict{
+            static_cast<std::uint32_t>((dictionaries.size() - record_field_count * sizeof(SnapshotDictionary)) / sizeof(SnapshotString)),
+            static_cast<std::uint32_t>(values_[f].size()),
+        };
+        std::memcpy(dictionaries.data() + f * sizeof(dict), &dict, sizeof(dict));
+        auto bytes = std::as_bytes(std::span(values_[f]));
+        dictionaries.insert(dictionaries.end(), bytes.begin(), bytes.end());
+    }
+
+    std::vector<std::byte> perfect_hash;
+    if (perfect_hash_) {
+        auto hash = PerfectHash::build(keys);
+        if (!hash) {
+            return std::unexpected{LookupError("Failed to build a perfect hash over the keys")};
+        }
+        perfect_hash = hash->serialize();
+    }
+
+    std::string pool;
+    pool.reserve(pool_size_);
+    for (const auto& block : blocks_) pool.append(block.data.get(), block.size);
+
+    struct Blob { std::uint32_t tag; const void* data; std::size_t size; };
+    std::vector<Blob> blobs = {
+        {snapshot_keys_tag, keys.data(), keys.size() * sizeof(std::uint32_t)},
+        {snapshot_ranges_tag, ranges.data(), ranges.size() * sizeof(SnapshotRange)},
+        {snapshot_records_tag, records.data(), records.size() * sizeof(SnapshotRecord)},
+        {snapshot_dictionaries_tag, dictionaries.data(), dictionaries.size()},
+        {snapshot_strings_tag, pool.data(), pool.size()},
+    };
+    if (perfect_hash_) blobs.push_back({snapshot_perfect_hash_tag, perfect_hash.data(), perfect_hash.size()});
+
+    std::vector<SnapshotSection> sections;
+    std::size_t offset = align_up(sizeof(SnapshotHeader) + blobs.size() * sizeof(SnapshotSection));
+    for (const auto& blob : blobs) {
+        sections.push_back({blob.tag, 0, offset, blob.size});
+        offset = align_up(offset + blob.size);
+    }
+
+    SnapshotHeader header{};
+    std::memcpy(header.magic, snapshot_magic, sizeof(header.magic));
+    header.version = snapshot_version;
+    header.section_count = static_cast<std::uint16_t>(sections.size());
+    header.record_count = static_cast<std::uint32_t>(records.size());
+    header.file_size = offset;
+
+    std::vector<std::byte> image(offset);
+    std::memcpy(image.data(), &header, sizeof(header));
+    std::memcpy(image.data() + sizeof(header), sections.data(), sections.size() * sizeof(SnapshotSection));
+    for (std::size_t i = 0; i < sections.size(); ++i) {
+        if (blobs[i].size > 0) std::memcpy(image.data() + sections[i].offset, blobs[i].data, blobs[i].size);
+    }
+    return image;
+}
+
+auto SnapshotWriter::write(const std::string& path) -> std::expected<void, LookupError> {
+    auto image = serialize();
+    if (!image) {
+        return std::unexpected{image.error()};
+    }
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        return std::unexpected{LookupError(std::format("Failed to open {} for writing", path))};
+    }
+    out.write(reinterpret_cast<const char*>(image->data()), static_cast<std::streamsize>(image->size()));
+    if (!out) {
+        return std::unexpected{LookupError(std::format("Failed to write {}", path))};
+    }
+    return {};
+}
+}
@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+#include "csv_loader.hpp"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace LibBIN;
+
+TEST(CsvReaderTest, SplitsFieldsAndStripsQuotes) {
+    CsvReader reader("411111,\"US\",,VISA\r\n\"a,b\",x\n");
+    CsvRow row;
+    ASSERT_TRUE(reader.next(row));
+    ASSERT_EQ(row.size, 4u);
+    EXPECT_EQ(row.fields[0], "411111");
+    EXPECT_EQ(row.fields[1], "US");
+    EXPECT_EQ(row.fields[2], "");
+    EXPECT_EQ(row.fields[3], "VISA");
+
+    ASSERT_TRUE(reader.next(row));
+    ASSERT_EQ(row.size, 2u);
+    EXPECT_EQ(row.fields[0], "a,b");
+    EXPECT_EQ(row.fields[1], "x");
+    EXPECT_FALSE(reader.next(row));
+}
+
+TEST(CsvReaderTest, QuotedFields) {
+    CsvReader reader("1,\"Bank \"\"One\"\", Ltd\",\"multi\r\nline\",\"\"\r\n2,\"\"\"\"\n");
+    CsvRow row;
+    ASSERT_TRUE(reader.next(row));
+    ASSERT_EQ(row.size, 4u);
+    EXPECT_EQ(row.fields[1], "Bank \"One\", Ltd");
+    EXPECT_EQ(row.fields[2], "multi\r\nline");
+    EXPECT_EQ(row.fields[3], "");
+    ASSERT_TRUE(reader.next(row));
+    ASSERT_EQ(row.size, 2u);
+    EXPECT_EQ(row.fields[1], "\"");
+    EXPECT_FALSE(reader.next(row));
+}
+
+TEST(CsvReaderTest, QuotesSpanBlocks) {
+    // Fields straddle the scanner's 64-byte blocks.
+    std::string bank = "\"" + std::string(100, 'x') + ",\n" + std::string(70, 'y') + "\"";
+    std::string text;
+    for (int i = 0; i < 20; ++i) text += std::to_string(i) + "," + bank + ",end\n";
+    CsvReader reader(text);
+    CsvRow row;
+    for (int i = 0; i < 20; ++i) {
+        ASSERT_TRUE(reader.next(row));
+        ASSERT_EQ(row.size, 3u);
+        EXPECT_EQ(row.fields[0], std::to_string(i));
+        EXPECT_EQ(row.fields[1], bank.substr(1, bank.size() - 2));
+        EXPECT_EQ(row.fields[2], "end");
+    }
+    EXPECT_FALSE(reader.next(row));
+}
+
+TEST(CsvReaderTest, CountsFieldsPastTheLimit) {
+    CsvReader reader("1,2,3,4,5,6,7,8,9");
+    CsvRow row;
+    ASSERT_TRUE(reader.next(row));
+    EXPECT_EQ(row.size, 9u);
+    EXPECT_EQ(row.fields[6], "7");
+    EXPECT_FALSE(reader.next(row));
+}
+
+TEST(CsvReaderTest, EmptyLines) {
+    CsvReader reader("\n\r\nx");
+    CsvRow row;
+    ASSERT_TRUE(reader.next(row));
+    EXPECT_EQ(row.size, 0u);
+    ASSERT_TRUE(reader.next(row));
+    EXPECT_EQ(row.size, 0u);
+    ASSERT_TRUE(reader.next(row));
+    EXPECT_EQ(row.fields[0], "x");
+    EXPECT_FALSE(reader.next(row));
+}
+
+TEST(CsvReaderTest, ReadBinCsv) {
+    auto path = (std::filesystem::temp_directory_path() /
+                 ("libbin_csv_" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()) + ".csv")).string();
+    std::ofstream(path) << "bin,country,country_name,scheme,type,brand,bank\n"
+                        << "411111,US,United States,VISA,CREDIT,CLASSIC,\"Bank A\"\n"
+                        << "short,row\n"
+                        << "522222,,,MASTERCARD,DEBIT,,Bank B\n";
+
+    std::vector<std::string> rows;
+    auto stats = read_bin_csv(path, [&](const RecordFields& r) {
+        rows.push_back(std::string(r.bin) + "|" + std::string(r.scheme) + "|" + std::string(r.bank) +
+                       (r.is_valid ? "" : "|invalid"));
+    });
+    std::remove(path.c_str());
+
+    ASSERT_TRUE(stats.has_value()) << stats.error().what();
+    EXPECT_EQ(stats->rows, 3u);
+    EXPECT_EQ(stats->skipped_rows, 1u);
+    EXPECT_EQ(rows, (std::vector<std::string>{"411111|VISA|Bank A", "522222|MASTERCARD|Bank B|invalid"}));
+}
+
+TEST(CsvReaderTest, ParallelMatchesSequential) {
+    auto path = (std::filesystem::temp_directory_path() /
+                 ("libbin_csv_parallel_" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()) + ".csv")).string();
+    {
+        std::ofstream out(path);
+        out << "bin,country,country_name,scheme,type,brand,bank\n";
+        std::mt19937 rng(3);
+        for (int i = 0; i < 5000; ++i) {
+            // Few distinct BINs so duplicates span chunks; last one wins.
+            out << 400000 + rng() % 1500 << ",C" << rng() % 40 << ",,S" << rng() % 5 << ",T,B" << rng() % 9;
+            switch (i % 3) {
+                case 0: out << ",Bank " << i << "\n"; break;
+                case 1: out << ",\"Bank, " << i << "\nLtd\"\n"; break;
+                default: out << ",\"\"\"Bank\"\" " << i << "\"\n"; break;
+            }
+            if (i % 500 == 0) out << "short\n" << 500000 + i << "-" << 500000 + i + 99 << ",US,,VISA,T,B,Range " << i << "\n";
+        }
+    }
+
+    SnapshotWriter sequential;
+    auto stats = read_bin_csv(path, [&](const RecordFields& r) { sequential.add(r); });
+    ASSERT_TRUE(stats.has_value());
+    auto expected = Snapshot::from_image(*sequential.serialize());
+    ASSERT_TRUE(expected.has_value());
+
+    for (unsigned threads : {2u, 3u, 8u, 0u}) {
+        auto parallel = read_bin_csv_parallel(path, threads);
+        ASSERT_TRUE(parallel.has_value()) << parallel.error().what();
+        EXPECT_EQ(parallel->stats.rows, stats->rows);
+        EXPECT_EQ(parallel->stats.skipped_rows, stats->skipped_rows);
+        auto image = parallel->writer.serialize();
+        ASSERT_TRUE(image.has_value());
+        auto actual = Snapshot::from_image(std::move(*image));
+        ASSERT_TRUE(actual.has_value());
+        ASSERT_EQ(actual->size(), expected->size()) << threads;
+        ASSERT_EQ(actual->keys().size(), expected->keys().size());
+        for (std::uint32_t i = 0; i < expected->size(); ++i) {
+            EXPECT_EQ(actual->record(i).summary(), expected->record(i).summary()) << threads << " " << i;
+        }
+    }
+    std::remove(path.c_str());
+}
+
+TEST(CsvReaderTest, MissingFile) {
+    auto stats = read_bin_csv("/nonexistent/bin_data.csv", [](const RecordFields&) {});
+    ASSERT_FALSE(stats.has_value());
+    EXPECT_NE(std::string(stats.error().what()).find("Failed to open BIN CSV file"), std::string::npos);
+}
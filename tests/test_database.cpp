@@ -0,0 +1,508 @@
+#include <gtest/gtest.h>
+#include "database.hpp"
+#include "numa.hpp"
+#include "residency.hpp"
+#include "snapshot.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace LibBIN;
+
+class DatabaseTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        for (const auto& path : paths) std::remove(path.c_str());
+    }
+
+    auto write_csv(const std::string& name, const std::vector<std::string>& rows) -> std::string {
+        return write_file(name, "bin,country,country_name,scheme,type,brand,bank", rows);
+    }
+
+    auto write_delta(const std::string& name, const std::vector<std::string>& rows) -> std::string {
+        return write_file(name, "op,bin,country,country_name,scheme,type,brand,bank", rows);
+    }
+
+    auto write_file(const std::string& name, const std::string& header, const std::vector<std::string>& rows)
+        -> std::string {
+        auto path = (std::filesystem::temp_directory_path() /
+                     ("libbin_db_" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()) + "_" + name + ".csv")).string();
+        std::ofstream out(path);
+        out << header << "\n";
+        for (const auto& row : rows) out << row << "\n";
+        paths.push_back(path);
+        return path;
+    }
+
+    std::vector<std::string> paths;
+};
+
+TEST_F(DatabaseTest, InstancesAreIndependent) {
+    Database vendor_a;
+    Database vendor_b;
+    ASSERT_TRUE(vendor_a.load_bins(write_csv("a", {"411111,US,,VISA,CREDIT,CLASSIC,Bank A"})).has_value());
+    ASSERT_TRUE(vendor_b.load_bins(write_csv("b", {"411111,GB,,VISA,DEBIT,GOLD,Bank B",
+                                                   "522222,GB,,MASTERCARD,DEBIT,,Bank B"})).has_value());
+
+    EXPECT_EQ(vendor_a.size(), 1u);
+    EXPECT_EQ(vendor_b.size(), 2u);
+    EXPECT_EQ(vendor_a.Search("411111")->bank, "Bank A");
+    EXPECT_EQ(vendor_b.Search("411111")->bank, "Bank B");
+    EXPECT_EQ(vendor_a.TrySearch("522222").error(), ErrorCode::NotFound);
+    EXPECT_TRUE(vendor_b.TrySearch("522222").has_value());
+}
+
+TEST_F(DatabaseTest, NotLoaded) {
+    Database db;
+    EXPECT_FALSE(db.loaded());
+    EXPECT_EQ(db.size(), 0u);
+    EXPECT_EQ(db.index_kind(), IndexKind::Auto);
+    EXPECT_EQ(db.TrySearch("411111").error(), ErrorCode::NotLoaded);
+    EXPECT_FALSE(db.reload().has_value());
+}
+
+TEST_F(DatabaseTest, ReloadPicksUpChanges) {
+    Database db;
+    auto path = write_csv("reload", {"411111,US,,VISA,CREDIT,CLASSIC,Old Bank"});
+    ASSERT_TRUE(db.load_bins(path, {.index = IndexKind::Direct}).has_value());
+    EXPECT_EQ(db.Search("411111")->bank, "Old Bank");
+
+    write_csv("reload", {"411111,US,,VISA,CREDIT,CLASSIC,New Bank", "422222,US,,VISA,DEBIT,,New Bank"});
+    ASSERT_TRUE(db.reload().has_value());
+    EXPECT_EQ(db.Search("411111")->bank, "New Bank");
+    EXPECT_TRUE(db.Search("422222").has_value());
+    EXPECT_EQ(db.index_kind(), IndexKind::Direct);
+}
+
+TEST_F(DatabaseTest, ReloadDoesNotWaitForLaterReaders) {
+    Database db;
+    auto path = write_csv("epoch", {"411111,US,,VISA,CREDIT,CLASSIC,Old Bank"});
+    ASSERT_TRUE(db.load_bins(path).has_value());
+    write_csv("epoch", {"411111,US,,VISA,CREDIT,CLASSIC,New Bank"});
+
+    std::atomic<bool> reloaded{false};
+    std::thread writer;
+    std::optional<Database::ReadGuard> earlier(std::in_place, db);
+    writer = std::thread([&] {
+        EXPECT_TRUE(db.reload().has_value());
+        reloaded = true;
+    });
+    // Once the new data is visible the writer is waiting for `earlier`; a
+    // guard taken now, on the same thread and stripe, must not hold it up.
+    while (db.Search("411111")->bank != "New Bank") std::this_thread::yield();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(reloaded.load());
+    {
+        Database::ReadGuard later(db);
+        earlier.reset();
+        for (int i = 0; i < 500 && !reloaded.load(); ++i) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        EXPECT_TRUE(reloaded.load());
+    }
+    writer.join();
+}
+
+TEST_F(DatabaseTest, FailedLoadKeepsData) {
+    Database db;
+    ASSERT_TRUE(db.load_bins(write_csv("keep", {"411111,US,,VISA,CREDIT,CLASSIC,Bank A"})).has_value());
+    auto failed = db.load_bins("/nonexistent/bin_data.csv");
+    ASSERT_FALSE(failed.has_value());
+    EXPECT_TRUE(db.Search("411111").has_value());
+    EXPECT_TRUE(db.reload().has_value());
+}
+
+TEST_F(DatabaseTest, DeltaUpsertsAndDeletes) {
+    Database db;
+    ASSERT_TRUE(db.load_bins(write_csv("base", {"411111,US,,VISA,CREDIT,CLASSIC,Old Bank",
+                                                "422222,US,,VISA,DEBIT,,Gone Bank",
+                                                "433333,US,,VISA,DEBIT,,Kept Bank",
+                                                "500000-500999,GB,,MASTERCARD,CREDIT,,Range Bank"})).has_value());
+
+    auto stats = db.apply_delta(write_delta("d1", {"U,411111,US,,VISA,CREDIT,CLASSIC,New Bank",
+                                                   "U,444444,FR,,VISA,DEBIT,,Added Bank",
+                                                   "D,422222",
+                                                   "D,500000-500999",
+                                                   "X,455555",
+                                                   "U,4x,US,,VISA,,,Bad"}));
+    ASSERT_TRUE(stats.has_value());
+    EXPECT_EQ(stats->upserts, 2u);
+    EXPECT_EQ(stats->deletes, 2u);
+    EXPECT_EQ(stats->skipped_rows, 2u);
+
+    EXPECT_EQ(db.Search("411111")->bank, "New Bank");
+    EXPECT_EQ(db.Search("444444")->country, "FR");
+    EXPECT_EQ(db.Search("433333")->bank, "Kept Bank");
+    EXPECT_EQ(db.TrySearch("422222").error(), ErrorCode::NotFound);
+    EXPECT_EQ(db.TrySearch("50050000").error(), ErrorCode::NotFound);
+    EXPECT_EQ(db.size(), 3u);
+    EXPECT_EQ(db.overlay_size(), 4u);
+}
+
+TEST_F(DatabaseTest, DeltasAccumulate) {
+    Database db;
+    ASSERT_TRUE(db.load_bins(write_csv("base", {"411111,US,,VISA,CREDIT,CLASSIC,Base Bank"})).has_value());
+    ASSERT_TRUE(db.apply_delta(write_delta("d1", {"U,422222,US,,VISA,DEBIT,,First",
+                                                  "D,411111"})).has_value());
+    ASSERT_TRUE(db.apply_delta(write_delta("d2", {"U,411111,US,,VISA,CREDIT,,Back",
+                                                  "U,422222,US,,VISA,DEBIT,,Second",
+                                                  "U,433333,US,,VISA,DEBIT,,Third",
+                                                  "D,433333"})).has_value());
+
+    EXPECT_EQ(db.Search("411111")->bank, "Back");
+    EXPECT_EQ(db.Search("422222")->bank, "Second");
+    EXPECT_EQ(db.TrySearch("433333").error(), ErrorCode::NotFound);
+    EXPECT_EQ(db.size(), 2u);
+}
+
+TEST_F(DatabaseTest, DeltaLongestPrefix) {
+    Database db;
+    ASSERT_TRUE(db.load_bins(write_csv("base", {"411111,US,,VISA,CREDIT,,Six",
+                                                "41111122,US,,VISA,CREDIT,,Eight"}),
+                             {.index = IndexKind::Prefix}).has_value());
+    ASSERT_TRUE(db.apply_delta(write_delta("d1", {"D,41111122", "U,4111112,US,,VISA,CREDIT,,Seven"})).has_value());
+
+    EXPECT_EQ(db.Search("41111122", MatchMode::LongestPrefix)->bank, "Seven");
+    EXPECT_EQ(db.Search("41111129", MatchMode::LongestPrefix)->bank, "Seven");
+    EXPECT_EQ(db.TrySearch("41111011", MatchMode::LongestPrefix).error(), ErrorCode::NotFound);
+    EXPECT_EQ(db.Search("41111101", MatchMode::LongestPrefix)->bank, "Six");
+    EXPECT_EQ(db.TrySearch("41111122").error(), ErrorCode::NotFound);
+}
+
+TEST_F(DatabaseTest, PanLookup) {
+    Database db;
+    EXPECT_EQ(db.TrySearchPan("4111111111111111").error(), ErrorCode::NotLoaded);
+    ASSERT_TRUE(db.load_bins(write_csv("base", {"411111,US,,VISA,CREDIT,,Six",
+                                                "41111111,US,,VISA,CREDIT,,Eight",
+                                                "500000-500999,GB,,MASTERCARD,CREDIT,,Range"})).has_value());
+
+    EXPECT_EQ(db.SearchPan("4111 1111 1111 1111")->bank, "Eight");
+    EXPECT_EQ(db.SearchPan("4111-1122-3344-5569")->bank, "Six");
+    EXPECT_EQ(db.SearchPan("5005000000000004")->bank, "Range");
+    EXPECT_EQ(db.TrySearchPan("4222222222222").error(), ErrorCode::NotFound);
+
+    auto bad = db.TrySearchPan("4111111111111112");
+    EXPECT_EQ(bad.error(), ErrorCode::InvalidChecksum);
+    EXPECT_EQ(bad.error().input(), "411111");
+    auto error = db.SearchPan("4111111111111112").error();
+    EXPECT_EQ(std::string(error.what()).find("4111111111111112"), std::string::npos);
+}
+
+TEST_F(DatabaseTest, PanBatchMatchesTrySearchPan) {
+    Database db;
+    ASSERT_TRUE(db.load_bins(write_csv("base", {"411111,US,,VISA,CREDIT,,Six",
+                                                "41111111,US,,VISA,CREDIT,,Eight"})).has_value());
+    std::vector<std::string_view> pans;
+    for (int i = 0; i < 5; ++i) {
+        pans.insert(pans.end(), {"4111111111111111", "4111 1122 3344 5569", "4111111111111112",
+                                 "4222222222222", "41111", "4111-1111-1111-1111-111"});
+    }
+    std::vector<std::expected<ResultView, SearchError>> out(pans.size(), std::unexpected{SearchError{ErrorCode::NotLoaded, ""}});
+    db.SearchPanBatch(pans, out);
+    for (std::size_t i = 0; i < pans.size(); ++i) {
+        auto single = db.TrySearchPan(pans[i]);
+        ASSERT_EQ(out[i].has_value(), single.has_value()) << pans[i];
+        if (single) {
+            EXPECT_EQ(out[i]->bank(), single->bank());
+        } else {
+            EXPECT_EQ(out[i].error(), single.error().code());
+        }
+    }
+}
+
+TEST_F(DatabaseTest, CompactMatchesOverlay) {
+    Database db;
+    ASSERT_TRUE(db.load_bins(write_csv("base", {"411111,US,,VISA,CREDIT,CLASSIC,Old Bank",
+                                                "422222,US,,VISA,DEBIT,,Gone Bank",
+                                                "500000-500999,GB,,MASTERCARD,CREDIT,,Range Bank"}),
+                             {.index = IndexKind::Direct}).has_value());
+    ASSERT_TRUE(db.apply_delta(write_delta("d1", {"U,411111,US,,VISA,CREDIT,CLASSIC,New Bank",
+                                                  "U,444444,FR,,VISA,DEBIT,,Added Bank",
+                                                  "U,600000-600999,DE,,VISA,DEBIT,,New Range",
+                                                  "D,422222"})).has_value());
+    const std::size_t size = db.size();
+
+    ASSERT_TRUE(db.compact().has_value());
+    EXPECT_EQ(db.overlay_size(), 0u);
+    EXPECT_EQ(db.size(), size);
+    EXPECT_EQ(db.index_kind(), IndexKind::Direct);
+    EXPECT_EQ(db.Search("411111")->bank, "New Bank");
+    EXPECT_EQ(db.Search("444444")->bank, "Added Bank");
+    EXPECT_EQ(db.Search("60012345")->bank, "New Range");
+    EXPECT_EQ(db.Search("50012345")->bank, "Range Bank");
+    EXPECT_EQ(db.TrySearch("422222").error(), ErrorCode::NotFound);
+
+    // Reload returns to the source file, dropping the compacted deltas.
+    ASSERT_TRUE(db.reload().has_value());
+    EXPECT_EQ(db.Search("411111")->bank, "Old Bank");
+}
+
+TEST_F(DatabaseTest, BackgroundCompaction) {
+    Database db;
+    ASSERT_TRUE(db.load_bins(write_csv("base", {"411111,US,,VISA,CREDIT,CLASSIC,Base Bank"}),
+                             {.compaction_threshold = 2}).has_value());
+    ASSERT_TRUE(db.apply_delta(write_delta("d1", {"U,422222,US,,VISA,DEBIT,,A",
+                                                  "U,433333,US,,VISA,DEBIT,,B"})).has_value());
+    for (int i = 0; i < 1000 && db.overlay_size() != 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_EQ(db.overlay_size(), 0u);
+    EXPECT_EQ(db.size(), 3u);
+    EXPECT_EQ(db.Search("433333")->bank, "B");
+}
+
+TEST_F(DatabaseTest, DeltaErrors) {
+    Database db;
+    EXPECT_FALSE(db.apply_delta(write_delta("early", {"D,411111"})).has_value());
+    ASSERT_TRUE(db.load_bins(write_csv("base", {"411111,US,,VISA,CREDIT,CLASSIC,Bank"})).has_value());
+    EXPECT_FALSE(db.apply_delta("/nonexistent/delta.csv").has_value());
+    EXPECT_EQ(db.overlay_size(), 0u);
+    EXPECT_TRUE(db.Search("411111").has_value());
+}
+
+TEST_F(DatabaseTest, OverlappingRangesSurviveCompaction) {
+    Database db;
+    ASSERT_TRUE(db.load_bins(write_csv("ranges", {"411111,US,,VISA,CREDIT,CLASSIC,Bank",
+                                                  "500000-500999,GB,,MASTERCARD,CREDIT,,Old Range"}),
+                             {.compaction_threshold = 0}).has_value());
+
+    // Overlapping a live base range, or a range upserted earlier, is skipped.
+    auto stats = db.apply_delta(write_delta("overlap", {"U,500500-500600,GB,,MASTERCARD,CREDIT,,New Range",
+                                                       "U,600000-600999,GB,,MASTERCARD,CREDIT,,Other Range",
+                                                       "U,600500-601999,GB,,MASTERCARD,CREDIT,,Wide Range",
+                                                       "U,500000-500999,GB,,MASTERCARD,CREDIT,,Same Bounds"}));
+    ASSERT_TRUE(stats.has_value());
+    EXPECT_EQ(stats->upserts, 2u);
+    EXPECT_EQ(stats->skipped_rows, 2u);
+    auto before = std::pair{db.Search("50055000")->bank, db.Search("60070000")->bank};
+    EXPECT_EQ(before, std::pair(std::string("Same Bounds"), std::string("Other Range")));
+    EXPECT_EQ(db.size(), 3u);
+    ASSERT_TRUE(db.compact().has_value());
+    EXPECT_EQ(std::pair(db.Search("50055000")->bank, db.Search("60070000")->bank), before);
+    EXPECT_EQ(db.size(), 3u);
+
+    // Once the old range is deleted, a narrower one can take its place.
+    stats = db.apply_delta(write_delta("replace", {"D,500000-500999",
+                                                   "U,500500-500600,GB,,MASTERCARD,CREDIT,,New Range"}));
+    ASSERT_TRUE(stats.has_value());
+    EXPECT_EQ(stats->skipped_rows, 0u);
+    EXPECT_EQ(db.Search("50055000")->bank, "New Range");
+    EXPECT_EQ(db.TrySearch("50010000").error(), ErrorCode::NotFound);
+    ASSERT_TRUE(db.compact().has_value());
+    EXPECT_EQ(db.Search("50055000")->bank, "New Range");
+    EXPECT_EQ(db.TrySearch("50010000").error(), ErrorCode::NotFound);
+    EXPECT_EQ(db.size(), 3u);
+}
+
+TEST_F(DatabaseTest, PackedLayout) {
+    Database db;
+    ASSERT_TRUE(db.load_bins(write_csv("packed", {"411111,US,,VISA,CREDIT,CLASSIC,Bank A",
+                                                  "41111122,US,,VISA,CREDIT,GOLD,Bank B",
+                                                  "500000-500999,GB,,MASTERCARD,CREDIT,,Range Bank"}),
+                             {.packed = true}).has_value());
+    EXPECT_EQ(db.index_kind(), IndexKind::Sorted);
+    EXPECT_EQ(db.Search("411111")->bank, "Bank A");
+    EXPECT_EQ(db.Search("41111122")->brand, "GOLD");
+    EXPECT_EQ(db.Search("41111199", MatchMode::LongestPrefix)->bin, "411111");
+    EXPECT_EQ(db.Search("50012345")->bin, "500000-500999");
+
+    ASSERT_TRUE(db.apply_delta(write_delta("d1", {"D,411111", "U,422222,US,,VISA,DEBIT,,Bank C"})).has_value());
+    ASSERT_TRUE(db.compact().has_value());
+    EXPECT_EQ(db.TrySearch("411111").error(), ErrorCode::NotFound);
+    EXPECT_EQ(db.Search("422222")->bank, "Bank C");
+    EXPECT_EQ(db.size(), 3u);
+}
+
+TEST_F(DatabaseTest, ResidencyOptions) {
+    auto path = write_csv("resident", {"411111,US,,VISA,CREDIT,CLASSIC,Bank A",
+                                       "500000-500999,GB,,MASTERCARD,CREDIT,,Range Bank"});
+    Database db;
+    ASSERT_TRUE(db.load_bins(path, {.index = IndexKind::Direct, .huge_pages = HugePages::Transparent, .prefault = true})
+                    .has_value());
+    EXPECT_EQ(db.Search("411111")->bank, "Bank A");
+
+    // Locking and reserved huge pages depend on the host's limits; either
+    // the load succeeds or it fails cleanly.
+    Database locked;
+    auto pinned = locked.load_bins(path, {.lock_memory = true});
+    EXPECT_EQ(pinned.has_value(), locked.loaded());
+    if (pinned) {
+        EXPECT_EQ(locked.Search("50012345")->bank, "Range Bank");
+    }
+
+    Database huge;
+    auto backed = huge.load_bins(path, {.huge_pages = HugePages::Explicit});
+    EXPECT_EQ(backed.has_value(), huge.loaded());
+    if (backed) {
+        EXPECT_EQ(huge.Search("411111")->bank, "Bank A");
+    }
+}
+
+// Locked kB of this process, from /proc/self/status.
+static auto locked_kb() -> long {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.rfind("VmLck:", 0) == 0) return std::stol(line.substr(6));
+    }
+    return -1;
+}
+
+TEST(ResidencyTest, UnlockKeepsSharedPagesLocked) {
+    // Two tables sharing a page, as small heap vectors do.
+    alignas(4096) static std::byte page[8192];
+    MemoryRegion first(page, 100);
+    MemoryRegion second(page + 100, 100);
+    MemoryRegion both[] = {first, second};
+    if (!lock_memory(both) || locked_kb() < 0) GTEST_SKIP() << "mlock not permitted";
+    const long locked = locked_kb();
+    EXPECT_GE(locked, 4);
+    unlock_memory(std::span(both).first(1));
+    EXPECT_EQ(locked_kb(), locked);
+
+    // Pages wholly inside a region are unlocked.
+    MemoryRegion whole(page, sizeof(page));
+    ASSERT_TRUE(lock_memory(std::span(&whole, 1)));
+    unlock_memory(std::span(&whole, 1));
+    EXPECT_LT(locked_kb(), locked);
+}
+
+TEST_F(DatabaseTest, NumaReplicas) {
+    const auto& topology = NumaTopology::get();
+    ASSERT_FALSE(topology.nodes.empty());
+    EXPECT_TRUE(std::count(topology.nodes.begin(), topology.nodes.end(), current_numa_node()) == 1);
+
+    auto path = write_csv("numa", {"411111,US,,VISA,CREDIT,CLASSIC,Bank A", "422222,US,,VISA,DEBIT,,Bank B"});
+    Database single;
+    Database replicated;
+    ASSERT_TRUE(single.load_bins(path, {.index = IndexKind::Direct}).has_value());
+    ASSERT_TRUE(replicated.load_bins(path, {.index = IndexKind::Direct, .numa_replicas = true}).has_value());
+    EXPECT_EQ(replicated.memory_usage(), single.memory_usage() * topology.nodes.size());
+    EXPECT_EQ(replicated.Search("411111")->bank, "Bank A");
+
+    ASSERT_TRUE(replicated.apply_delta(write_delta("numa_delta", {"D,411111"})).has_value());
+    EXPECT_EQ(replicated.TrySearch("411111").error(), ErrorCode::NotFound);
+    ASSERT_TRUE(replicated.compact().has_value());
+    EXPECT_EQ(replicated.size(), 1u);
+    EXPECT_EQ(replicated.Search("422222")->bank, "Bank B");
+}
+
+TEST_F(DatabaseTest, StoredPerfectHash) {
+    SnapshotWriter writer;
+    ASSERT_TRUE(writer.add(Result{"411111", "VISA", "CREDIT", "", "Six", "", "US", "", "", false, true}));
+    ASSERT_TRUE(writer.add(Result{"41111122", "VISA", "CREDIT", "", "Eight", "", "US", "", "", false, true}));
+    writer.store_perfect_hash(true);
+    auto path = write_file("perfect", "", {});
+    ASSERT_TRUE(writer.write(path).has_value());
+
+    Database db;
+    ASSERT_TRUE(db.load_snapshot(path).has_value());
+    EXPECT_EQ(db.index_kind(), IndexKind::Perfect);
+    EXPECT_EQ(db.Search("411111")->bank, "Six");
+    EXPECT_EQ(db.Search("41111129", MatchMode::LongestPrefix)->bank, "Six");
+    EXPECT_EQ(db.Search("41111122", MatchMode::LongestPrefix)->bank, "Eight");
+    EXPECT_EQ(db.TrySearch("422222").error(), ErrorCode::NotFound);
+
+    ASSERT_TRUE(db.load_snapshot(path, {.packed = true}).has_value());
+    EXPECT_EQ(db.index_kind(), IndexKind::Sorted);
+    ASSERT_TRUE(db.load_snapshot(path, {.index = IndexKind::Perfect, .packed = true}).has_value());
+    EXPECT_EQ(db.Search("41111122")->bank, "Eight");
+    EXPECT_EQ(db.TrySearch("422222").error(), ErrorCode::NotFound);
+}
+
+TEST_F(DatabaseTest, ScanVisitsKeysInOrder) {
+    Database db;
+    EXPECT_EQ(db.Scan("411100", "41119999", [](const ResultView&) {}).error(), ErrorCode::NotLoaded);
+    ASSERT_TRUE(db.load_bins(write_csv("base", {"411200,US,,VISA,CREDIT,,A",
+                                                "411111,US,,VISA,CREDIT,,B",
+                                                "41111122,US,,VISA,CREDIT,,C",
+                                                "4111113,US,,VISA,CREDIT,,D",
+                                                "412000,US,,VISA,CREDIT,,E",
+                                                "411000-411099,US,,VISA,CREDIT,,Range"}),
+                             {.index = IndexKind::Tree}).has_value());
+    std::vector<std::string> bins;
+    auto collect = [&](const ResultView& view) { bins.emplace_back(view.bin()); };
+
+    EXPECT_EQ(db.Scan("411100", "411299", collect), 4u);
+    EXPECT_EQ(bins, (std::vector<std::string>{"411111", "41111122", "4111113", "411200"}));
+    bins.clear();
+    EXPECT_EQ(db.Scan("4111112", "41111129", collect), 1u);
+    EXPECT_EQ(bins, std::vector<std::string>{"41111122"});
+    EXPECT_EQ(db.Scan("411x", "4111", collect).error(), ErrorCode::InvalidFormat);
+
+    ASSERT_TRUE(db.apply_delta(write_delta("d1", {"D,411111", "U,411150,US,,VISA,CREDIT,,New",
+                                                  "U,411200,US,,VISA,CREDIT,,A2"})).has_value());
+    bins.clear();
+    std::vector<std::string> banks;
+    EXPECT_EQ(db.Scan("411100", "411299", [&](const ResultView& view) {
+        bins.emplace_back(view.bin());
+        banks.emplace_back(view.bank());
+    }), 4u);
+    EXPECT_EQ(bins, (std::vector<std::string>{"41111122", "4111113", "411150", "411200"}));
+    EXPECT_EQ(banks.back(), "A2");
+}
+
+TEST_F(DatabaseTest, NegativeFilterKeepsMatches) {
+    auto path = write_csv("filtered", {"411111,US,,VISA,CREDIT,CLASSIC,Bank A",
+                                       "41111122,US,,VISA,CREDIT,GOLD,Bank B",
+                                       "500000-500999,GB,,MASTERCARD,CREDIT,,Range Bank"});
+    Database filtered;
+    Database plain;
+    ASSERT_TRUE(filtered.load_bins(path).has_value());
+    ASSERT_TRUE(plain.load_bins(path, {.negative_filter = false}).has_value());
+    EXPECT_GT(filtered.memory_usage(), plain.memory_usage());
+
+    for (const char* bin : {"411111", "41111122", "41111199", "50012345", "500999", "411112", "600000", "5010000"}) {
+        for (MatchMode mode : {MatchMode::Exact, MatchMode::LongestPrefix}) {
+            auto expected = plain.TrySearch(bin, mode);
+            auto actual = filtered.TrySearch(bin, mode);
+            ASSERT_EQ(actual.has_value(), expected.has_value()) << bin;
+            if (expected) {
+                EXPECT_EQ(actual->bin(), expected->bin()) << bin;
+            }
+        }
+    }
+
+    // Deltas land in the overlay, which the base's filter does not cover.
+    ASSERT_TRUE(filtered.apply_delta(write_delta("filtered_delta", {"U,600000,US,,VISA,DEBIT,,Bank C"})).has_value());
+    EXPECT_EQ(filtered.Search("600000")->bank, "Bank C");
+    EXPECT_EQ(filtered.Search("60000012", MatchMode::LongestPrefix)->bank, "Bank C");
+    EXPECT_EQ(filtered.TrySearch("700000").error(), ErrorCode::NotFound);
+    ASSERT_TRUE(filtered.compact().has_value());
+    EXPECT_EQ(filtered.Search("600000")->bank, "Bank C");
+}
+
+class DatabaseIndexTest : public ::testing::TestWithParam<IndexKind> {};
+
+TEST_P(DatabaseIndexTest, MatchesSortedIndex) {
+    Database reference;
+    Database db;
+    ASSERT_TRUE(reference.load_bins("/usr/share/LibBIN/bin_data.csv", {.index = IndexKind::Sorted}).has_value());
+    ASSERT_TRUE(db.load_bins("/usr/share/LibBIN/bin_data.csv", {.index = GetParam()}).has_value());
+    EXPECT_EQ(db.index_kind(), GetParam());
+    EXPECT_EQ(db.size(), reference.size());
+    EXPECT_GT(db.memory_usage(), 0u);
+
+    std::vector<std::string> queries = {"100100", "100105", "000000", "abc123", "10010", "1001000", "10010599"};
+    for (int i = 0; i < 2000; ++i) queries.push_back(std::to_string(100000 + i * 449 % 900000));
+    for (const auto& query : queries) {
+        for (MatchMode mode : {MatchMode::Exact, MatchMode::LongestPrefix}) {
+            auto expected = reference.TrySearch(query, mode);
+            auto actual = db.TrySearch(query, mode);
+            ASSERT_EQ(actual.has_value(), expected.has_value()) << query;
+            if (expected) {
+                EXPECT_EQ(actual->bin(), expected->bin()) << query;
+            } else {
+                EXPECT_EQ(actual.error().code(), expected.error().code()) << query;
+            }
+        }
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(IndexKinds, DatabaseIndexTest,
+                         ::testing::Values(IndexKind::Hash, IndexKind::Direct, IndexKind::Prefix, IndexKind::Perfect,
+                                           IndexKind::Tree));
@@ -0,0 +1,400 @@
+#include <gtest/gtest.h>
+#include "direct_index.hpp"
+#include "flat_hash_index.hpp"
+#include "index_backend.hpp"
+#include "negative_filter.hpp"
+#include "packed_columns.hpp"
+#include "packed_keys.hpp"
+#include "perfect_hash.hpp"
+#include "prefix_index.hpp"
+#include "range_index.hpp"
+#include "search_tree.hpp"
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace LibBIN;
+
+static auto make_keys(std::size_t count, std::uint32_t seed) -> std::vector<std::uint32_t> {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> length(6, 8);
+    std::vector<std::uint32_t> keys;
+    while (keys.size() < count) {
+        std::string bin(static_cast<std::size_t>(length(rng)), '0');
+        for (char& c : bin) c = static_cast<char>('0' + rng() % 10);
+        keys.push_back(BinKey::parse(bin)->packed);
+    }
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    return keys;
+}
+
+static auto sorted_find(const std::vector<std::uint32_t>& keys, BinKey key) -> std::uint32_t {
+    auto it = std::lower_bound(keys.begin(), keys.end(), key.packed);
+    if (it == keys.end() || *it != key.packed) return 0xFFFFFFFFu;
+    return static_cast<std::uint32_t>(it - keys.begin());
+}
+
+TEST(DirectIndexTest, FindsEveryKey) {
+    auto keys = make_keys(5000, 1);
+    DirectIndex index(keys);
+    for (std::size_t id = 0; id < keys.size(); ++id) {
+        EXPECT_EQ(index.find(BinKey{keys[id]}), id);
+    }
+}
+
+TEST(DirectIndexTest, MatchesSortedSearchOnMisses) {
+    auto keys = make_keys(5000, 2);
+    auto probes = make_keys(5000, 3);
+    DirectIndex index(keys);
+    for (auto probe : probes) {
+        EXPECT_EQ(index.find(BinKey{probe}), sorted_find(keys, BinKey{probe}));
+    }
+}
+
+TEST(DirectIndexTest, DistinguishesLengths) {
+    std::vector<std::uint32_t> keys = {
+        BinKey::parse("411111")->packed,
+        BinKey::parse("41111100")->packed,
+    };
+    DirectIndex index(keys);
+    EXPECT_EQ(index.find(*BinKey::parse("411111")), 0u);
+    EXPECT_EQ(index.find(*BinKey::parse("41111100")), 1u);
+    EXPECT_EQ(index.find(*BinKey::parse("4111110")), DirectIndex::npos);
+}
+
+TEST(DirectIndexTest, EmptyIndex) {
+    DirectIndex index;
+    EXPECT_EQ(index.find(*BinKey::parse("411111")), DirectIndex::npos);
+    EXPECT_EQ(index.find(*BinKey::parse("41111111")), DirectIndex::npos);
+}
+
+TEST(FlatHashIndexTest, FindsEveryKey) {
+    for (std::size_t count : {0u, 1u, 15u, 16u, 17u, 1000u, 50000u}) {
+        auto keys = make_keys(count, static_cast<std::uint32_t>(count) + 20);
+        keys.resize(std::min(keys.size(), count));
+        auto probes = make_keys(5000, 21);
+        FlatHashIndex index(keys);
+        EXPECT_EQ(index.size(), keys.size());
+        for (std::size_t id = 0; id < keys.size(); ++id) {
+            ASSERT_EQ(index.find(BinKey{keys[id]}), id) << count;
+        }
+        for (auto probe : probes) {
+            EXPECT_EQ(index.find(BinKey{probe}), sorted_find(keys, BinKey{probe}));
+        }
+    }
+}
+
+TEST(FlatHashIndexTest, CollidingLowBits) {
+    // Keys differing only in high digits, so a weak hash would pile them
+    // into few groups.
+    std::vector<std::uint32_t> keys;
+    for (std::uint32_t i = 0; i < 4096; ++i) keys.push_back(BinKey{(i * 10000u) << 2}.packed);
+    FlatHashIndex index(keys);
+    for (std::size_t id = 0; id < keys.size(); ++id) {
+        ASSERT_EQ(index.find(BinKey{keys[id]}), id);
+    }
+    EXPECT_EQ(index.find(BinKey{(4096u * 10000u) << 2}), FlatHashIndex::npos);
+    EXPECT_LE(index.memory_usage(), keys.size() * 2 * (sizeof(std::uint32_t) * 2 + 1));
+}
+
+TEST(PackedKeysTest, FindsEveryKey) {
+    auto keys = make_keys(5000, 7);
+    PackedKeys index(keys);
+    ASSERT_EQ(index.size(), keys.size());
+    for (std::size_t id = 0; id < keys.size(); ++id) {
+        EXPECT_EQ(index.find(BinKey{keys[id]}), id);
+        EXPECT_EQ(index.key(id).packed, keys[id]);
+        EXPECT_EQ(index.text(id), BinKey{keys[id]}.to_string());
+    }
+    // Smaller than the raw key table plus one 8-byte slot of digits per key.
+    EXPECT_LT(index.memory_usage(), keys.size() * (sizeof(std::uint32_t) + 8));
+}
+
+TEST(PackedKeysTest, MatchesSortedSearchOnMisses) {
+    auto keys = make_keys(5000, 8);
+    auto probes = make_keys(5000, 9);
+    PackedKeys index(keys);
+    for (auto probe : probes) {
+        EXPECT_EQ(index.find(BinKey{probe}), sorted_find(keys, BinKey{probe}));
+    }
+    EXPECT_EQ(index.find(BinKey{keys.front() - 1}), PackedKeys::npos);
+    EXPECT_EQ(index.find(BinKey{keys.back() + 1}), PackedKeys::npos);
+}
+
+TEST(PackedKeysTest, WideAndEmptyBlocks) {
+    std::vector<std::uint32_t> keys = {
+        BinKey::parse("000000")->packed,
+        BinKey::parse("4111111")->packed,
+        BinKey::parse("99999999")->packed,
+    };
+    PackedKeys index(keys);
+    for (std::size_t id = 0; id < keys.size(); ++id) EXPECT_EQ(index.find(BinKey{keys[id]}), id);
+    EXPECT_EQ(index.text(1), "4111111");
+    EXPECT_EQ(PackedKeys{}.find(*BinKey::parse("411111")), PackedKeys::npos);
+}
+
+TEST(PackedColumnsTest, RoundTrip) {
+    const std::vector<unsigned> widths = {0, 1, 5, 32, 13};
+    PackedColumns table(widths, 1000);
+    EXPECT_EQ(table.row_bits(), 51u);
+    std::mt19937 rng(10);
+    std::vector<std::vector<std::uint32_t>> expected(1000, std::vector<std::uint32_t>(widths.size()));
+    for (std::size_t row = 0; row < expected.size(); ++row) {
+        for (std::size_t column = 0; column < widths.size(); ++column) {
+            std::uint32_t value = widths[column] == 0 ? 0 : rng() >> (32 - widths[column]);
+            expected[row][column] = value;
+            table.set(row, column, value);
+        }
+    }
+    for (std::size_t row = 0; row < expected.size(); ++row) {
+        for (std::size_t column = 0; column < widths.size(); ++column) {
+            EXPECT_EQ(table.get(row, column), expected[row][column]);
+        }
+    }
+}
+
+static auto reference_longest(const std::vector<std::uint32_t>& keys, BinKey key) -> std::uint32_t {
+    for (std::size_t digits = key.digits(); digits >= BinKey::min_digits; --digits) {
+        std::uint32_t id = sorted_find(keys, key.prefix(digits));
+        if (id != 0xFFFFFFFFu) return id;
+    }
+    return 0xFFFFFFFFu;
+}
+
+TEST(PerfectHashTest, FindsEveryKey) {
+    auto keys = make_keys(20000, 8);
+    auto probes = make_keys(20000, 9);
+    auto hash = PerfectHash::build(keys);
+    ASSERT_TRUE(hash.has_value());
+    EXPECT_EQ(hash->size(), keys.size());
+    for (std::size_t id = 0; id < keys.size(); ++id) {
+        EXPECT_EQ(hash->find(BinKey{keys[id]}), id);
+    }
+    for (auto probe : probes) {
+        EXPECT_EQ(hash->find(BinKey{probe}), sorted_find(keys, BinKey{probe}));
+    }
+    // The id table holds one id per key; pilots and remap table stay
+    // within a few bits per key.
+    std::size_t function_bytes = hash->memory_usage() - keys.size() * sizeof(std::uint32_t);
+    EXPECT_LT(function_bytes * 8, keys.size() * 6);
+}
+
+TEST(PerfectHashTest, SerializedViewMatchesBuild) {
+    auto keys = make_keys(3000, 10);
+    auto hash = PerfectHash::build(keys);
+    ASSERT_TRUE(hash.has_value());
+    auto bytes = hash->serialize();
+    auto view = PerfectHash::view(bytes, keys);
+    ASSERT_TRUE(view.has_value());
+    EXPECT_EQ(view->memory_usage(), 0u);
+    for (std::size_t id = 0; id < keys.size(); ++id) {
+        EXPECT_EQ(view->find(BinKey{keys[id]}), id);
+    }
+
+    EXPECT_FALSE(PerfectHash::view(bytes, std::span(keys).first(keys.size() - 1)));
+    EXPECT_FALSE(PerfectHash::view(std::span(bytes).first(bytes.size() - 1), keys));
+    bytes[bytes.size() - 1] = std::byte{0xFF};
+    EXPECT_FALSE(PerfectHash::view(bytes, keys));
+}
+
+TEST(PerfectHashTest, SmallAndEmptySets) {
+    auto empty = PerfectHash::build({});
+    ASSERT_TRUE(empty.has_value());
+    EXPECT_TRUE(empty->empty());
+    EXPECT_EQ(empty->find(*BinKey::parse("411111")), PerfectHash::npos);
+
+    std::vector<std::uint32_t> one = {BinKey::parse("411111")->packed};
+    auto single = PerfectHash::build(one);
+    ASSERT_TRUE(single.has_value());
+    EXPECT_EQ(single->find(*BinKey::parse("411111")), 0u);
+    EXPECT_EQ(single->find(*BinKey::parse("4111111")), PerfectHash::npos);
+}
+
+TEST(SearchTreeTest, LowerBoundMatchesSortedSearch) {
+    for (std::size_t count : {0u, 1u, 16u, 17u, 272u, 273u, 4913u, 50000u}) {
+        auto keys = make_keys(count, static_cast<std::uint32_t>(count));
+        keys.resize(std::min(keys.size(), count));
+        auto probes = make_keys(2000, 12);
+        SearchTree tree(keys);
+        EXPECT_EQ(tree.size(), keys.size());
+        for (std::size_t id = 0; id < keys.size(); ++id) {
+            ASSERT_EQ(tree.find(BinKey{keys[id]}), id) << count;
+            EXPECT_EQ(tree.key(id), keys[id]);
+        }
+        for (auto probe : probes) {
+            auto expected = std::lower_bound(keys.begin(), keys.end(), probe) - keys.begin();
+            ASSERT_EQ(tree.lower_bound(BinKey{probe}), static_cast<std::size_t>(expected)) << count;
+            EXPECT_EQ(tree.find(BinKey{probe}), sorted_find(keys, BinKey{probe}));
+        }
+        EXPECT_EQ(tree.lower_bound(BinKey{0}), 0u);
+        EXPECT_EQ(tree.lower_bound(*BinKey::parse("99999999")), keys.size() - (!keys.empty() && keys.back() == BinKey::parse("99999999")->packed));
+    }
+}
+
+TEST(IndexSelectionTest, ProfilesKeys) {
+    std::vector<std::uint32_t> keys = {BinKey::parse("411111")->packed, BinKey::parse("4111112")->packed,
+                                       BinKey::parse("41111122")->packed, BinKey::parse("422222")->packed};
+    auto data = DatasetProfile::of(keys, 3);
+    EXPECT_EQ(data.keys, 4u);
+    EXPECT_EQ(data.six_digit_keys, 2u);
+    EXPECT_EQ(data.long_keys, 2u);
+    EXPECT_EQ(data.ranges, 3u);
+    EXPECT_FALSE(data.snapshot);
+
+    auto built = build_index<PerfectHash>(keys);
+    ASSERT_TRUE(built.has_value());
+    EXPECT_EQ(built->find(BinKey{keys[2]}), 2u);
+    EXPECT_EQ(build_index<FlatHashIndex>(keys)->find(BinKey{keys[3]}), 3u);
+}
+
+TEST(IndexSelectionTest, PicksByShape) {
+    DatasetProfile sparse{.keys = 20000, .six_digit_keys = 19500, .long_keys = 500};
+    EXPECT_EQ(select_index(sparse, {}), IndexKind::Hash);
+    EXPECT_EQ(select_index(sparse, {.index = IndexKind::Prefix}), IndexKind::Prefix);
+    EXPECT_EQ(select_index(sparse, {.packed = true}), IndexKind::Sorted);
+
+    DatasetProfile dense{.keys = 300000, .six_digit_keys = 290000, .long_keys = 10000};
+    EXPECT_EQ(select_index(dense, {}), IndexKind::Direct);
+    dense.snapshot = dense.stored_perfect_hash = true;
+    EXPECT_EQ(select_index(dense, {}), IndexKind::Direct);
+    dense.long_keys = 100000;
+    EXPECT_EQ(select_index(dense, {}), IndexKind::Perfect);
+
+    DatasetProfile ranges{.keys = 100, .six_digit_keys = 100, .ranges = 5000};
+    EXPECT_EQ(select_index(ranges, {}), IndexKind::Sorted);
+
+    DatasetProfile snapshot{.keys = 20000, .six_digit_keys = 20000, .snapshot = true};
+    EXPECT_EQ(select_index(snapshot, {}), IndexKind::Sorted);
+    snapshot.keys = snapshot.six_digit_keys = 100000;
+    EXPECT_EQ(select_index(snapshot, {}), IndexKind::Tree);
+}
+
+TEST(PrefixIndexTest, ExactFindMatchesSortedSearch) {
+    auto keys = make_keys(5000, 4);
+    auto probes = make_keys(5000, 5);
+    PrefixIndex index(keys);
+    for (std::size_t id = 0; id < keys.size(); ++id) {
+        EXPECT_EQ(index.find(BinKey{keys[id]}), id);
+    }
+    for (auto probe : probes) {
+        EXPECT_EQ(index.find(BinKey{probe}), sorted_find(keys, BinKey{probe}));
+    }
+}
+
+TEST(PrefixIndexTest, LongestMatchPrefersMostSpecific) {
+    std::vector<std::uint32_t> keys = {
+        BinKey::parse("411111")->packed,
+        BinKey::parse("4111112")->packed,
+        BinKey::parse("41111123")->packed,
+        BinKey::parse("42222233")->packed,
+    };
+    std::sort(keys.begin(), keys.end());
+    PrefixIndex index(keys);
+    auto id_of = [&](const char* bin) { return sorted_find(keys, *BinKey::parse(bin)); };
+
+    EXPECT_EQ(index.find_longest(*BinKey::parse("41111123")), id_of("41111123"));
+    EXPECT_EQ(index.find_longest(*BinKey::parse("41111129")), id_of("4111112"));
+    EXPECT_EQ(index.find_longest(*BinKey::parse("41111199")), id_of("411111"));
+    EXPECT_EQ(index.find_longest(*BinKey::parse("4111119")), id_of("411111"));
+    EXPECT_EQ(index.find_longest(*BinKey::parse("411111")), id_of("411111"));
+    EXPECT_EQ(index.find_longest(*BinKey::parse("42222234")), PrefixIndex::npos);
+    EXPECT_EQ(index.find_longest(*BinKey::parse("422222")), PrefixIndex::npos);
+    EXPECT_EQ(index.find(*BinKey::parse("4111112")), id_of("4111112"));
+    EXPECT_EQ(index.find(*BinKey::parse("4222223")), PrefixIndex::npos);
+}
+
+TEST(PrefixIndexTest, LongestMatchAgreesWithProbing) {
+    auto keys = make_keys(20000, 6);
+    auto probes = make_keys(20000, 7);
+    PrefixIndex index(keys);
+    for (auto probe : probes) {
+        EXPECT_EQ(index.find_longest(BinKey{probe}), reference_longest(keys, BinKey{probe}));
+    }
+}
+
+static auto make_range(const char* text) -> SnapshotRange {
+    auto range = *BinRange::parse(text);
+    return {range.first, range.last};
+}
+
+TEST(RangeIndexTest, ParsesRanges) {
+    auto range = BinRange::parse("400000-400999");
+    ASSERT_TRUE(range);
+    EXPECT_EQ(range->first, 40000000u);
+    EXPECT_EQ(range->last, 40099999u);
+    EXPECT_TRUE(range->contains(*BinKey::parse("400123")));
+    EXPECT_TRUE(range->contains(*BinKey::parse("40099999")));
+    EXPECT_FALSE(range->contains(*BinKey::parse("401000")));
+    EXPECT_FALSE(BinRange::parse("400999-400000"));
+    EXPECT_FALSE(BinRange::parse("400000"));
+    EXPECT_FALSE(BinRange::parse("40000-400999"));
+}
+
+TEST(RangeIndexTest, FindsContainingRange) {
+    std::vector<SnapshotRange> ranges = {
+        make_range("10000000-10000099"),
+        make_range("400000-400999"),
+        make_range("51000000-51000000"),
+    };
+    RangeIndex index(ranges, 10);
+    EXPECT_EQ(index.find(*BinKey::parse("10000050")), 10u);
+    EXPECT_EQ(index.find(*BinKey::parse("100000")), 10u);
+    EXPECT_EQ(index.find(*BinKey::parse("400500")), 11u);
+    EXPECT_EQ(index.find(*BinKey::parse("4005001")), 11u);
+    EXPECT_EQ(index.find(*BinKey::parse("51000000")), 12u);
+    EXPECT_EQ(index.find(*BinKey::parse("510000")), RangeIndex::npos);
+    EXPECT_EQ(index.find(*BinKey::parse("10000100")), RangeIndex::npos);
+    EXPECT_EQ(index.find(*BinKey::parse("099999")), RangeIndex::npos);
+    EXPECT_EQ(index.find(*BinKey::parse("99999999")), RangeIndex::npos);
+    EXPECT_EQ(RangeIndex{}.find(*BinKey::parse("400500")), RangeIndex::npos);
+}
+
+TEST(NegativeFilterTest, NeverRejectsStoredKeysOrRanges) {
+    auto keys = make_keys(20000, 13);
+    std::vector<SnapshotRange> ranges = {make_range("10000000-10000099"), make_range("400000-400999")};
+    NegativeFilter filter(keys, ranges);
+    for (std::uint32_t key : keys) {
+        ASSERT_TRUE(filter.may_contain(BinKey{key}));
+        ASSERT_TRUE(filter.may_contain_prefix(BinKey{key}));
+    }
+    EXPECT_TRUE(filter.may_contain(*BinKey::parse("10000050")));
+    EXPECT_TRUE(filter.may_contain(*BinKey::parse("400500")));
+    EXPECT_TRUE(filter.may_contain(*BinKey::parse("4009999")));
+    EXPECT_GT(filter.memory_usage(), NegativeFilter::prefixes / 8);
+
+    // A range's span costs no Bloom space.
+    std::vector<SnapshotRange> everything = {make_range("000000-999999")};
+    NegativeFilter wide(keys, everything);
+    EXPECT_EQ(wide.memory_usage(), NegativeFilter(keys, {}).memory_usage() + NegativeFilter::prefixes / 8);
+    EXPECT_TRUE(wide.may_contain(*BinKey::parse("12345678")));
+
+    NegativeFilter empty;
+    EXPECT_TRUE(empty.may_contain(*BinKey::parse("411111")));
+    EXPECT_TRUE(empty.may_contain_prefix(*BinKey::parse("411111")));
+}
+
+TEST(NegativeFilterTest, RejectsMostMisses) {
+    auto keys = make_keys(20000, 14);
+    NegativeFilter filter(keys, {});
+    std::size_t misses = 0;
+    std::size_t passed = 0;
+    std::size_t passed_under_prefix = 0;
+    for (std::uint32_t probe : make_keys(50000, 15)) {
+        if (sorted_find(keys, BinKey{probe}) != 0xFFFFFFFFu) continue;
+        ++misses;
+        passed += filter.may_contain(BinKey{probe});
+        // Misses under a used prefix are left to the Bloom filter.
+        passed_under_prefix += filter.may_contain(BinKey{probe}) && filter.may_contain_prefix(BinKey{probe});
+    }
+    EXPECT_GT(misses, 40000u);
+    EXPECT_LT(passed, misses / 50);
+    EXPECT_EQ(passed_under_prefix, passed);
+
+    std::vector<std::uint32_t> six = {BinKey::parse("411111")->packed};
+    NegativeFilter one(six, {});
+    EXPECT_TRUE(one.may_contain_prefix(*BinKey::parse("41111199")));
+    EXPECT_FALSE(one.may_contain_prefix(*BinKey::parse("411112")));
+    EXPECT_FALSE(one.may_contain(*BinKey::parse("411112")));
+}
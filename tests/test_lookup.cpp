@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 #include "lookup.hpp"
+#include <atomic>
+#include <chrono>
 #include <thread>
 #include <vector>
 #include <string>
@@ -146,3 +148,120 @@ TEST_F(LookupTest, ExtremelyLongString) {
     ASSERT_FALSE(result.has_value());
     EXPECT_STREQ(result.error().what(), ("Invalid BIN format: " + long_bin).c_str());
 }
+
+TEST_F(LookupTest, SearchViewMatchesSearch) {
+    auto view = Lookup::SearchView("100101");
+    auto result = Lookup::Search("100101");
+    ASSERT_TRUE(view.has_value());
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(view->bin(), result->bin);
+    EXPECT_EQ(view->country(), result->country);
+    EXPECT_EQ(view->scheme(), result->scheme);
+    EXPECT_EQ(view->bank(), result->bank);
+    EXPECT_EQ(view->prepaid(), result->prepaid);
+    EXPECT_EQ(view->to_result().summary(), result->summary());
+}
+
+TEST_F(LookupTest, SearchViewErrors) {
+    auto invalid = Lookup::SearchView("abc123");
+    ASSERT_FALSE(invalid.has_value());
+    EXPECT_STREQ(invalid.error().what(), "Invalid BIN format: abc123");
+
+    auto missing = Lookup::SearchView("000000");
+    ASSERT_FALSE(missing.has_value());
+    EXPECT_STREQ(missing.error().what(), "BIN not found: 000000");
+}
+
+TEST_F(LookupTest, TrySearchErrorCodes) {
+    auto hit = Lookup::TrySearch("100101");
+    ASSERT_TRUE(hit.has_value());
+    EXPECT_EQ(hit->bin(), "100101");
+
+    std::string query = "12#45@";
+    auto invalid = Lookup::TrySearch(query);
+    ASSERT_FALSE(invalid.has_value());
+    EXPECT_EQ(invalid.error(), ErrorCode::InvalidFormat);
+    EXPECT_EQ(invalid.error().input(), query);
+    EXPECT_STREQ(invalid.error().to_error().what(), "Invalid BIN format: 12#45@");
+
+    auto missing = Lookup::TrySearch("000000");
+    ASSERT_FALSE(missing.has_value());
+    EXPECT_EQ(missing.error().code(), ErrorCode::NotFound);
+    EXPECT_STREQ(missing.error().to_error().what(), "BIN not found: 000000");
+}
+
+TEST_F(LookupTest, SearchBatchMatchesTrySearch) {
+    std::vector<std::string> storage = {"100101", "abc123", "000000", "100102", "", "100103", "123456789"};
+    for (int i = 0; i < 40; ++i) storage.push_back(std::to_string(100100 + i % 12));
+    std::vector<std::string_view> bins(storage.begin(), storage.end());
+    std::vector<std::expected<ResultView, SearchError>> out(bins.size(), std::unexpected{SearchError{ErrorCode::NotLoaded, ""}});
+
+    Lookup::SearchBatch(bins, out);
+    for (std::size_t i = 0; i < bins.size(); ++i) {
+        auto expected = Lookup::TrySearch(bins[i]);
+        ASSERT_EQ(out[i].has_value(), expected.has_value()) << bins[i];
+        if (expected) {
+            EXPECT_EQ(out[i]->id(), expected->id());
+            EXPECT_EQ(out[i]->bin(), expected->bin());
+        } else {
+            EXPECT_EQ(out[i].error().code(), expected.error().code());
+            EXPECT_EQ(out[i].error().input().data(), bins[i].data());
+        }
+    }
+}
+
+TEST_F(LookupTest, SearchBatchStopsAtShorterSpan) {
+    std::vector<std::string_view> bins = {"100101", "100102", "100103"};
+    std::vector<std::expected<ResultView, SearchError>> out(2, std::unexpected{SearchError{ErrorCode::NotLoaded, ""}});
+    Lookup::SearchBatch(bins, out);
+    ASSERT_TRUE(out[0].has_value());
+    ASSERT_TRUE(out[1].has_value());
+    EXPECT_EQ(out[1]->bin(), "100102");
+}
+
+TEST_F(LookupTest, ReloadWhileSearching) {
+    std::atomic<bool> done{false};
+    std::atomic<int> failures{0};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&] {
+            while (!done.load()) {
+                auto result = Lookup::Search("100101");
+                if (!result || result->bin != "100101") ++failures;
+                std::vector<std::string_view> bins = {"100102", "100103", "000000"};
+                std::vector<std::expected<ResultView, SearchError>> out(bins.size(), std::unexpected{SearchError{ErrorCode::NotLoaded, ""}});
+                Lookup::ReadGuard guard;
+                Lookup::SearchBatch(bins, out);
+                if (!out[0] || out[0]->bin() != "100102" || out[2]) ++failures;
+            }
+        });
+    }
+    for (int i = 0; i < 3; ++i) {
+        auto reloaded = Lookup::reload();
+        EXPECT_TRUE(reloaded.has_value()) << reloaded.error().what();
+    }
+    done = true;
+    for (auto& reader : readers) reader.join();
+    EXPECT_EQ(failures.load(), 0);
+}
+
+TEST_F(LookupTest, ReloadWaitsForReadGuard) {
+    std::atomic<bool> reloaded{false};
+    std::thread writer;
+    {
+        Lookup::ReadGuard guard;
+        auto view = Lookup::SearchView("100101");
+        ASSERT_TRUE(view.has_value());
+        writer = std::thread([&] {
+            EXPECT_TRUE(Lookup::reload().has_value());
+            reloaded = true;
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        EXPECT_FALSE(reloaded.load());
+        EXPECT_EQ(view->bin(), "100101");
+        EXPECT_EQ(view->country(), "US");
+    }
+    writer.join();
+    EXPECT_TRUE(reloaded.load());
+    EXPECT_EQ(Lookup::SearchView("100101")->bin(), "100101");
+}
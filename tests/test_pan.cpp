@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+#include "pan.hpp"
+#include <random>
+#include <string>
+
+using namespace LibBIN;
+
+// Appends the digit that makes `digits` pass the Luhn check.
+static auto with_check_digit(std::string digits) -> std::string {
+    int sum = 0;
+    for (std::size_t i = 0; i < digits.size(); ++i) {
+        int d = digits[digits.size() - 1 - i] - '0';
+        if (i % 2 == 0) d = d * 2 > 9 ? d * 2 - 9 : d * 2;
+        sum += d;
+    }
+    return digits + static_cast<char>('0' + (10 - sum % 10) % 10);
+}
+
+TEST(PanTest, LuhnKnownNumbers) {
+    EXPECT_TRUE(luhn_valid("4111111111111111"));
+    EXPECT_TRUE(luhn_valid("5555555555554444"));
+    EXPECT_TRUE(luhn_valid("378282246310005"));
+    EXPECT_FALSE(luhn_valid("4111111111111112"));
+    EXPECT_FALSE(luhn_valid("41111111111a1111"));
+    EXPECT_FALSE(luhn_valid(""));
+}
+
+TEST(PanTest, SimdLuhnMatchesScalar) {
+    std::mt19937 rng(11);
+    for (int i = 0; i < 5000; ++i) {
+        std::string digits(1 + rng() % 32, '0');
+        for (char& c : digits) c = static_cast<char>('0' + rng() % 10);
+        if (i % 2 == 0) digits = with_check_digit(digits.substr(1));
+        bool expected = luhn_valid(digits, SimdLevel::Scalar);
+        for (SimdLevel level : {SimdLevel::SSSE3, SimdLevel::AVX2}) {
+            EXPECT_EQ(luhn_valid(digits, level), expected) << digits;
+        }
+    }
+}
+
+TEST(PanTest, ParsesLeadingEightDigits) {
+    auto key = parse_pan("4111 1111-1111 1111");
+    ASSERT_TRUE(key.has_value());
+    EXPECT_EQ(*key, *BinKey::parse("41111111"));
+    EXPECT_EQ(parse_pan("4111111111111111"), key);
+    EXPECT_EQ(*parse_pan(with_check_digit("00012345678")), *BinKey::parse("00012345"));
+    EXPECT_TRUE(parse_pan(with_check_digit("123456789012345678")).has_value());
+}
+
+TEST(PanTest, RejectsMalformed) {
+    EXPECT_EQ(parse_pan(with_check_digit("1234567890")).error(), ErrorCode::InvalidFormat);
+    EXPECT_EQ(parse_pan(with_check_digit("1234567890123456789")).error(), ErrorCode::InvalidFormat);
+    EXPECT_EQ(parse_pan("4111.1111.1111.1111").error(), ErrorCode::InvalidFormat);
+    EXPECT_EQ(parse_pan("4111111111111111\n").error(), ErrorCode::InvalidFormat);
+    EXPECT_EQ(parse_pan("").error(), ErrorCode::InvalidFormat);
+    EXPECT_EQ(parse_pan("4111111111111112").error(), ErrorCode::InvalidChecksum);
+    for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSSE3}) {
+        EXPECT_EQ(parse_pan("4111-1111-1111-1113", level).error(), ErrorCode::InvalidChecksum);
+    }
+}
@@ -0,0 +1,309 @@
+#include <gtest/gtest.h>
+#include "snapshot.hpp"
+#include <cstdio>
+#include <filesystem>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <vector>
+#include <string>
+
+using namespace LibBIN;
+
+static Result make_result(const std::string& bin, const std::string& bank, const std::string& country = "US") {
+    Result r{};
+    r.bin = bin;
+    r.scheme = "VISA";
+    r.type = "CREDIT";
+    r.brand = "CLASSIC";
+    r.bank = bank;
+    r.country = country;
+    return r;
+}
+
+class SnapshotTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path = (std::filesystem::temp_directory_path() /
+                ("libbin_snapshot_" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()) + "_" +
+                 ::testing::UnitTest::GetInstance()->current_test_info()->name() + ".lbin")).string();
+    }
+    void TearDown() override {
+        std::remove(path.c_str());
+    }
+    std::string path;
+};
+
+TEST(BinKeyTest, PacksDigitsAndLength) {
+    auto six = BinKey::parse("411111");
+    auto eight = BinKey::parse("41111100");
+    ASSERT_TRUE(six && eight);
+    EXPECT_EQ(six->digits(), 6u);
+    EXPECT_EQ(eight->digits(), 8u);
+    EXPECT_EQ(six->padded(), eight->padded());
+    EXPECT_LT(*six, *eight);
+    EXPECT_EQ(BinKey::parse("000100")->to_string(), "000100");
+    EXPECT_EQ(BinKey::parse("1234567")->to_string(), "1234567");
+}
+
+TEST(BinKeyTest, Prefix) {
+    auto key = *BinKey::parse("41234567");
+    EXPECT_EQ(key.prefix(8), key);
+    EXPECT_EQ(key.prefix(7), *BinKey::parse("4123456"));
+    EXPECT_EQ(key.prefix(6), *BinKey::parse("412345"));
+}
+
+TEST(BinKeyTest, RejectsMalformed) {
+    EXPECT_FALSE(BinKey::parse("12345"));
+    EXPECT_FALSE(BinKey::parse("123456789"));
+    EXPECT_FALSE(BinKey::parse("12a456"));
+    EXPECT_FALSE(BinKey::parse(""));
+}
+
+static auto parse_inputs() -> std::vector<std::string> {
+    std::vector<std::string> inputs = {"", "12345", "123456789", "000000", "99999999", "1234567",
+                                       "12a456", "/00000", ":00000", "4111 11", "411111\n", "41111100"};
+    std::mt19937 rng(7);
+    for (int i = 0; i < 2000; ++i) {
+        std::string bin(5 + rng() % 5, '0');
+        for (char& c : bin) c = static_cast<char>(rng() % 16 == 0 ? '!' + rng() % 90 : '0' + rng() % 10);
+        inputs.push_back(bin);
+    }
+    return inputs;
+}
+
+TEST(BinKeyTest, SimdParseMatchesScalar) {
+    for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSSE3, SimdLevel::AVX2}) {
+        for (const auto& input : parse_inputs()) {
+            EXPECT_EQ(parse_bin(input, level), BinKey::parse(input)) << input;
+        }
+    }
+}
+
+TEST(BinKeyTest, SimdBatchParseMatchesScalar) {
+    auto inputs = parse_inputs();
+    std::vector<std::string_view> bins(inputs.begin(), inputs.end());
+    for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSSE3, SimdLevel::AVX2}) {
+        std::vector<std::optional<BinKey>> out(bins.size() - 3, BinKey{});
+        parse_bins(bins, out, level);
+        for (std::size_t i = 0; i < out.size(); ++i) {
+            EXPECT_EQ(out[i], BinKey::parse(bins[i])) << bins[i];
+        }
+    }
+}
+
+TEST_F(SnapshotTest, RoundTrip) {
+    SnapshotWriter writer;
+    ASSERT_TRUE(writer.add(make_result("411111", "Bank A")));
+    ASSERT_TRUE(writer.add(make_result("00010001", "Bank B", "GB")));
+    ASSERT_TRUE(writer.add(make_result("411111", "Bank C")));
+    EXPECT_FALSE(writer.add(make_result("41x111", "Bad")));
+    ASSERT_TRUE(writer.write(path).has_value());
+
+    auto snapshot = Snapshot::open(path);
+    ASSERT_TRUE(snapshot.has_value()) << snapshot.error().what();
+    EXPECT_EQ(snapshot->size(), 2u);
+    EXPECT_EQ(snapshot->key(0).to_string(), "00010001");
+
+    auto index = snapshot->find(*BinKey::parse("411111"));
+    ASSERT_TRUE(index.has_value());
+    Result r = snapshot->record(*index);
+    EXPECT_EQ(r.bin, "411111");
+    EXPECT_EQ(r.bank, "Bank C");
+    EXPECT_EQ(r.scheme, "VISA");
+    EXPECT_TRUE(r.is_valid);
+
+    EXPECT_FALSE(snapshot->find(*BinKey::parse("4111110")));
+}
+
+TEST_F(SnapshotTest, StoresRangesAfterKeys) {
+    SnapshotWriter writer;
+    ASSERT_TRUE(writer.add(make_result("411111", "Point")));
+    ASSERT_TRUE(writer.add(make_result("500000-500999", "Range A")));
+    ASSERT_TRUE(writer.add(make_result("500500-501999", "Overlap")));
+    ASSERT_TRUE(writer.add(make_result("40000000-40000099", "Range B")));
+    ASSERT_TRUE(writer.write(path).has_value());
+    EXPECT_EQ(writer.overlapping_ranges(), 1u);
+
+    auto snapshot = Snapshot::open(path);
+    ASSERT_TRUE(snapshot.has_value()) << snapshot.error().what();
+    EXPECT_EQ(snapshot->size(), 3u);
+    ASSERT_EQ(snapshot->keys().size(), 1u);
+    ASSERT_EQ(snapshot->ranges().size(), 2u);
+    EXPECT_EQ(snapshot->ranges()[0].first, 40000000u);
+    EXPECT_EQ(snapshot->record(1).bank, "Range B");
+    EXPECT_EQ(snapshot->record(2).bank, "Range A");
+    EXPECT_EQ(snapshot->record(2).bin, "500000-500999");
+}
+
+TEST_F(SnapshotTest, DictionaryEncodesFields) {
+    SnapshotWriter writer;
+    for (int i = 0; i < 100; ++i) {
+        Result r = make_result(std::to_string(400000 + i), "Bank " + std::to_string(i % 7), i % 2 ? "US" : "GB");
+        r.country_code = r.country;
+        r.prepaid = i % 3 == 0;
+        ASSERT_TRUE(writer.add(r));
+    }
+    auto image = writer.serialize();
+    ASSERT_TRUE(image.has_value());
+    auto snapshot = Snapshot::from_image(std::move(*image));
+    ASSERT_TRUE(snapshot.has_value()) << snapshot.error().what();
+
+    EXPECT_EQ(snapshot->dictionary_size(RecordField::Scheme), 1u);
+    EXPECT_EQ(snapshot->dictionary_size(RecordField::Country), 2u);
+    EXPECT_EQ(snapshot->dictionary_size(RecordField::Bank), 7u);
+    EXPECT_EQ(snapshot->dictionary_size(RecordField::Level), 1u);
+    for (std::uint32_t i = 0; i < 100; ++i) {
+        Result r = snapshot->record(i);
+        EXPECT_EQ(r.bin, std::to_string(400000 + i));
+        EXPECT_EQ(r.bank, "Bank " + std::to_string(i % 7));
+        EXPECT_EQ(r.country, i % 2 ? "US" : "GB");
+        EXPECT_EQ(r.country_code, r.country);
+        EXPECT_EQ(r.prepaid, i % 3 == 0);
+        EXPECT_EQ(r.level, "");
+    }
+}
+
+TEST_F(SnapshotTest, PackedLayoutMatchesImage) {
+    SnapshotWriter writer;
+    std::mt19937 rng(12);
+    for (int i = 0; i < 3000; ++i) {
+        std::string bin = std::to_string(400000 + rng() % 100000);
+        if (i % 5 == 1) bin += std::to_string(rng() % 10);
+        if (i % 5 == 2) bin += std::to_string(10 + rng() % 90);
+        Result r = make_result(bin, "Bank " + std::to_string(rng() % 300), i % 2 ? "US" : "GB");
+        r.level = i % 3 ? "GOLD" : "";
+        r.prepaid = i % 4 == 0;
+        r.is_valid = i % 9 != 0;
+        ASSERT_TRUE(writer.add(r));
+    }
+    ASSERT_TRUE(writer.add(make_result("30000000-30000099", "Range")));
+    ASSERT_TRUE(writer.write(path).has_value());
+
+    auto image = Snapshot::open(path);
+    auto packed = Snapshot::open(path);
+    ASSERT_TRUE(image.has_value() && packed.has_value());
+    packed->pack();
+    ASSERT_TRUE(packed->packed());
+    EXPECT_EQ(packed->image_size(), 0u);
+    EXPECT_TRUE(packed->keys().empty());
+    EXPECT_EQ(packed->key_count(), image->key_count());
+    EXPECT_EQ(packed->size(), image->size());
+    EXPECT_LT(packed->memory_usage() * 2, image->memory_usage());
+
+    for (std::uint32_t id = 0; id < image->size(); ++id) {
+        Result expected = image->record(id);
+        Result actual = packed->record(id);
+        EXPECT_EQ(actual.bin, expected.bin);
+        EXPECT_EQ(actual.bank, expected.bank);
+        EXPECT_EQ(actual.country, expected.country);
+        EXPECT_EQ(actual.level, expected.level);
+        EXPECT_EQ(actual.prepaid, expected.prepaid);
+        EXPECT_EQ(actual.is_valid, expected.is_valid);
+        if (id < image->key_count()) {
+            EXPECT_EQ(packed->find(image->key(id)), id);
+            EXPECT_EQ(packed->key(id), image->key(id));
+        }
+    }
+    EXPECT_EQ(packed->find(*BinKey::parse("399999")), std::nullopt);
+    for (const char* bin : {"000000", "399999", "4500005", "47777777", "99999999"}) {
+        EXPECT_EQ(packed->lower_bound(*BinKey::parse(bin)), image->lower_bound(*BinKey::parse(bin))) << bin;
+    }
+    EXPECT_EQ(packed->ranges()[0].first, 30000000u);
+}
+
+TEST_F(SnapshotTest, StoresPerfectHash) {
+    SnapshotWriter writer;
+    for (int i = 0; i < 500; ++i) ASSERT_TRUE(writer.add(make_result(std::to_string(400000 + i * 7), "Bank")));
+    ASSERT_TRUE(writer.add(make_result("30000000-30000099", "Range")));
+    writer.store_perfect_hash(true);
+    ASSERT_TRUE(writer.write(path).has_value());
+
+    auto snapshot = Snapshot::open(path);
+    ASSERT_TRUE(snapshot.has_value()) << snapshot.error().what();
+    const PerfectHash& hash = snapshot->perfect_hash();
+    EXPECT_EQ(hash.size(), snapshot->key_count());
+    for (std::uint32_t id = 0; id < snapshot->key_count(); ++id) {
+        EXPECT_EQ(hash.find(snapshot->key(id)), id);
+    }
+    EXPECT_EQ(hash.find(*BinKey::parse("400001")), PerfectHash::npos);
+
+    auto copied = snapshot->copy();
+    ASSERT_TRUE(copied.has_value());
+    EXPECT_EQ(copied->perfect_hash().find(snapshot->key(3)), 3u);
+    snapshot->pack();
+    EXPECT_TRUE(snapshot->perfect_hash().empty());
+
+    SnapshotWriter plain;
+    ASSERT_TRUE(plain.add(make_result("411111", "Bank")));
+    auto image = plain.serialize();
+    ASSERT_TRUE(image.has_value());
+    EXPECT_TRUE(Snapshot::from_image(std::move(*image))->perfect_hash().empty());
+}
+
+TEST_F(SnapshotTest, RejectsBadMagic) {
+    std::ofstream(path, std::ios::binary) << std::string(128, 'x');
+    auto snapshot = Snapshot::open(path);
+    ASSERT_FALSE(snapshot.has_value());
+    EXPECT_NE(std::string(snapshot.error().what()).find("bad magic"), std::string::npos);
+}
+
+TEST_F(SnapshotTest, RejectsTruncatedFile) {
+    SnapshotWriter writer;
+    writer.add(make_result("411111", "Bank A"));
+    auto image = writer.serialize();
+    ASSERT_TRUE(image.has_value());
+    std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char*>(image->data()),
+                                                static_cast<std::streamsize>(image->size() / 2));
+    EXPECT_FALSE(Snapshot::open(path).has_value());
+}
+
+// The bytes of the section tagged `tag` in a serialized image.
+static auto section_bytes(std::vector<std::byte>& image, std::uint32_t tag) -> std::span<std::byte> {
+    SnapshotHeader header{};
+    std::memcpy(&header, image.data(), sizeof(header));
+    for (std::size_t i = 0; i < header.section_count; ++i) {
+        SnapshotSection section{};
+        std::memcpy(&section, image.data() + sizeof(header) + i * sizeof(section), sizeof(section));
+        if (section.tag == tag) return {image.data() + section.offset, section.size};
+    }
+    return {};
+}
+
+TEST_F(SnapshotTest, RejectsCorruptKeys) {
+    SnapshotWriter writer;
+    writer.add(make_result("411111", "Bank A"));
+    writer.add(make_result("41111122", "Bank B"));
+    writer.add(make_result("500000-500999", "Range Bank"));
+    auto image = writer.serialize();
+    ASSERT_TRUE(image.has_value());
+    ASSERT_TRUE(Snapshot::from_image(*image).has_value());
+
+    auto corrupt_key = [&](std::size_t index, std::uint32_t value) {
+        auto copy = *image;
+        auto keys = section_bytes(copy, snapshot_keys_tag);
+        std::memcpy(keys.data() + index * sizeof(std::uint32_t), &value, sizeof(value));
+        return Snapshot::from_image(std::move(copy)).has_value();
+    };
+    EXPECT_FALSE(corrupt_key(1, 0xFFFFFFFFu));
+    EXPECT_FALSE(corrupt_key(1, 100'000'000u << 2 | 2));
+    // Nine digits.
+    EXPECT_FALSE(corrupt_key(1, 41111122u << 2 | 3));
+    // A 6-digit key with digits past its length.
+    EXPECT_FALSE(corrupt_key(1, 41111122u << 2));
+    // Out of order.
+    EXPECT_FALSE(corrupt_key(0, 42222200u << 2));
+    EXPECT_FALSE(corrupt_key(1, BinKey::parse("411111")->packed));
+    EXPECT_TRUE(corrupt_key(1, BinKey::parse("4111113")->packed));
+
+    auto copy = *image;
+    auto ranges = section_bytes(copy, snapshot_ranges_tag);
+    ASSERT_EQ(ranges.size(), sizeof(SnapshotRange));
+    SnapshotRange range{50000000, 100'000'000};
+    std::memcpy(ranges.data(), &range, sizeof(range));
+    EXPECT_FALSE(Snapshot::from_image(std::move(copy)).has_value());
+}
+
+TEST_F(SnapshotTest, MissingFile) {
+    EXPECT_FALSE(Snapshot::open(path + ".missing").has_value());
+}
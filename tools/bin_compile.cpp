@@ -0,0 +1,146 @@
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+#include "bin_key.hpp"
+#include "csv_loader.hpp"
+#include "snapshot.hpp"
+
+struct CompileOptions {
+    std::string input;
+    std::string output;
+    bool strict = false;
+    bool quiet = false;
+    bool perfect_hash = true;
+};
+
+void print_usage(const char* prog) {
+    std::cout << "Usage: " << prog << " [options] <input.csv> <output.lbin>\n"
+              << "Compiles a BIN CSV export into a .lbin snapshot for Lookup::load_snapshot().\n"
+              << "Options:\n"
+              << "  --strict              Fail on malformed rows, invalid BINs or overlapping ranges\n"
+              << "  --no-perfect-hash     Do not store a perfect hash index in the snapshot\n"
+              << "  --quiet               Only report errors\n"
+              << "  --help                Show this help\n";
+}
+
+int verify_snapshot(const std::string& path, std::size_t expected_records) {
+    auto snapshot = LibBIN::Snapshot::open(path);
+    if (!snapshot) {
+        std::cerr << "Error: " << snapshot.error().what() << "\n";
+        return 1;
+    }
+    if (snapshot->size() != expected_records) {
+        std::cerr << "Error: snapshot holds " << snapshot->size() << " records, expected " << expected_records << "\n";
+        return 1;
+    }
+    for (std::size_t i = 0; i < snapshot->keys().size(); ++i) {
+        auto key = snapshot->key(i);
+        if (i > 0 && !(snapshot->key(i - 1) < key)) {
+            std::cerr << "Error: snapshot keys are not strictly sorted at record " << i << "\n";
+            return 1;
+        }
+        if (snapshot->record(static_cast<std::uint32_t>(i)).bin != key.to_string()) {
+            std::cerr << "Error: record " << i << " does not match its key " << key.to_string() << "\n";
+            return 1;
+        }
+        const auto& hash = snapshot->perfect_hash();
+        if (!hash.empty() && hash.find(key) != i) {
+            std::cerr << "Error: perfect hash does not resolve key " << key.to_string() << "\n";
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    CompileOptions opts;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--strict") {
+            opts.strict = true;
+        } else if (arg == "--no-perfect-hash") {
+            opts.perfect_hash = false;
+        } else if (arg == "--quiet") {
+            opts.quiet = true;
+        } else if (arg == "--help") {
+            print_usage(argv[0]);
+            return 0;
+        } else if (!arg.empty() && arg[0] == '-') {
+            std::cerr << "Unknown argument: " << arg << "\n";
+            print_usage(argv[0]);
+            return 1;
+        } else if (opts.input.empty()) {
+            opts.input = arg;
+        } else if (opts.output.empty()) {
+            opts.output = arg;
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (opts.input.empty() || opts.output.empty()) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    LibBIN::SnapshotWriter writer;
+    writer.store_perfect_hash(opts.perfect_hash);
+    std::size_t invalid_bins = 0;
+    std::size_t missing_country = 0;
+    auto csv = LibBIN::read_bin_csv(opts.input, [&](const LibBIN::RecordFields& r) {
+        if (!writer.add(r)) {
+            ++invalid_bins;
+            if (opts.strict) std::cerr << "Invalid BIN or range: " << r.bin << "\n";
+            return;
+        }
+        if (!r.is_valid) ++missing_country;
+    });
+    if (!csv) {
+        std::cerr << "Error: " << csv.error().what() << "\n";
+        return 1;
+    }
+    if (opts.strict && (invalid_bins > 0 || csv->skipped_rows > 0)) {
+        std::cerr << "Error: " << invalid_bins << " invalid BINs and " << csv->skipped_rows
+                  << " malformed rows in " << opts.input << "\n";
+        return 1;
+    }
+
+    const std::size_t accepted = writer.size();
+    const std::string tmp_path = opts.output + ".tmp";
+    if (auto written = writer.write(tmp_path); !written) {
+        std::cerr << "Error: " << written.error().what() << "\n";
+        return 1;
+    }
+    const std::size_t records = writer.size();
+    if (opts.strict && writer.overlapping_ranges() > 0) {
+        std::cerr << "Error: " << writer.overlapping_ranges() << " overlapping ranges in " << opts.input << "\n";
+        std::remove(tmp_path.c_str());
+        return 1;
+    }
+    if (verify_snapshot(tmp_path, records) != 0) {
+        std::remove(tmp_path.c_str());
+        return 1;
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp_path, opts.output, ec);
+    if (ec) {
+        std::cerr << "Error: failed to move " << tmp_path << " to " << opts.output << ": " << ec.message() << "\n";
+        std::remove(tmp_path.c_str());
+        return 1;
+    }
+
+    if (!opts.quiet) {
+        std::cout << "Rows read:          " << csv->rows << "\n"
+                  << "Malformed rows:     " << csv->skipped_rows << "\n"
+                  << "Invalid BINs:       " << invalid_bins << "\n"
+                  << "Missing country:    " << missing_country << "\n"
+                  << "Duplicate entries:  " << accepted - records - writer.overlapping_ranges() << "\n"
+                  << "Overlapping ranges: " << writer.overlapping_ranges() << "\n"
+                  << "Records written:    " << records << "\n"
+                  << "Snapshot size:      " << std::filesystem::file_size(opts.output, ec) << " bytes\n"
+                  << "Output:             " << opts.output << "\n";
+    }
+    return 0;
+}